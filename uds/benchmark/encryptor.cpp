@@ -0,0 +1,304 @@
+#include <uds/threading/Hosting.h>
+#include <uds/cryptography/Encryptor.h>
+#include <openssl/rand.h>
+#include <chrono>
+
+using uds::Byte;
+using uds::cryptography::Encryptor;
+using uds::threading::Hosting;
+
+/* Every allocation path an Encryptor call can take: Malloc, operator new and OpenSSL's own allocator. */
+static std::atomic<uint64_t> NEW_ALLOCATIONS(0);
+static std::atomic<uint64_t> OPENSSL_ALLOCATIONS(0);
+
+void* operator new(size_t size) {
+    NEW_ALLOCATIONS++;
+    void* p = malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+static void* OpenSSL_Malloc(size_t size, const char* file, int line) noexcept {
+    OPENSSL_ALLOCATIONS++;
+    return malloc(size);
+}
+
+static void* OpenSSL_Realloc(void* p, size_t size, const char* file, int line) noexcept {
+    OPENSSL_ALLOCATIONS++;
+    return realloc(p, size);
+}
+
+static void OpenSSL_Free(void* p, const char* file, int line) noexcept {
+    free(p);
+}
+
+static uint64_t Allocations() noexcept {
+    return uds::MallocCount() + NEW_ALLOCATIONS + OPENSSL_ALLOCATIONS;
+}
+
+/* Untimed calls made before the clock starts, a measured run makes that many more calls than its iterations. */
+static const int BENCHMARK_WARMUP = 16;
+
+struct BenchmarkResult {
+    bool                                success = false;
+    double                              nanoseconds = 0;
+    double                              allocations = 0;
+};
+
+template<typename Operation>
+static BenchmarkResult Measure(int iterations, Operation&& operation) noexcept {
+    BenchmarkResult result;
+    for (int i = 0; i < BENCHMARK_WARMUP; i++) {
+        if (!operation()) {
+            return result;
+        }
+    }
+
+    uint64_t allocations = Allocations();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        if (!operation()) {
+            return result;
+        }
+    }
+
+    std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+    result.success = true;
+    result.nanoseconds = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count() / iterations;
+    result.allocations = (double)(Allocations() - allocations) / iterations;
+    return result;
+}
+
+/* Keys both directions with one salt and restarts both nonce counters, so a decrypt always follows its own encrypt. */
+static bool ResetEncryptor(Encryptor& encryptor) noexcept {
+    if (!encryptor.IsAEAD()) {
+        return true;
+    }
+
+    Byte salt[EVP_MAX_KEY_LENGTH];
+    int salt_size = encryptor.GetSaltSize();
+    if (salt_size > (int)sizeof(salt) || RAND_bytes(salt, salt_size) < 1) {
+        return false;
+    }
+    return encryptor.SetSalt(salt, salt_size, 1) && encryptor.SetSalt(salt, salt_size, 0);
+}
+
+static void PrintResult(const std::string& method, int size, const char* operation, const BenchmarkResult& result) noexcept {
+    if (!result.success) {
+        fprintf(stdout, "%-28s %8d  %-18s %12s %10s %10s\r\n", method.data(), size, operation, "failed", "-", "-");
+        return;
+    }
+
+    double gbps = result.nanoseconds > 0 ? size / result.nanoseconds : 0;
+    fprintf(stdout, "%-28s %8d  %-18s %12.1f %10.3f %10.2f\r\n", method.data(), size, operation, result.nanoseconds, gbps, result.allocations);
+}
+
+/* Decrypt needs ciphertext of the matching nonce, so every packet a run consumes is sealed in nonce order under a fresh salt before the clock starts. */
+static bool SealPackets(Encryptor& encryptor, const Byte* data, int size, int count, std::vector<std::pair<std::shared_ptr<Byte>, int>>& packets) noexcept {
+    if (!ResetEncryptor(encryptor)) {
+        return false;
+    }
+
+    packets.reserve(count);
+    for (int i = 0; i < count; i++) {
+        int outlen;
+        std::shared_ptr<Byte> packet = encryptor.Encrypt(const_cast<Byte*>(data), size, outlen);
+        if (!packet || outlen < size) {
+            return false;
+        }
+        packets.emplace_back(packet, outlen);
+    }
+    return true;
+}
+
+static void Benchmark(const std::string& method, int size, int64_t bytes) noexcept {
+    const std::shared_ptr<Encryptor> encryptor = uds::make_shared_object<Encryptor>(method, "uds");
+    const std::shared_ptr<Byte> plaintext = uds::make_shared_alloc<Byte>(size + EVP_MAX_BLOCK_LENGTH);
+    const std::shared_ptr<Byte> buffer = uds::make_shared_alloc<Byte>(size + EVP_MAX_BLOCK_LENGTH);
+    if (!encryptor || !plaintext || !buffer || RAND_bytes(plaintext.get(), size) < 1) {
+        return;
+    }
+
+    int iterations = (int)std::max<int64_t>(64, bytes / size);
+    int count = iterations + BENCHMARK_WARMUP;
+    Byte* data = plaintext.get();
+
+    BenchmarkResult encrypt;
+    if (ResetEncryptor(*encryptor)) {
+        encrypt = Measure(iterations,
+            [encryptor, data, size]() noexcept {
+                int outlen;
+                std::shared_ptr<Byte> packet = encryptor->Encrypt(data, size, outlen);
+                return packet && outlen >= size;
+            });
+    }
+
+    BenchmarkResult decrypt;
+    std::vector<std::pair<std::shared_ptr<Byte>, int>> packets;
+    if (SealPackets(*encryptor, data, size, count, packets)) {
+        int index = 0;
+        std::shared_ptr<Byte> text;
+        decrypt = Measure(iterations,
+            [encryptor, &packets, &index, &text, size]() noexcept {
+                const std::pair<std::shared_ptr<Byte>, int>& packet = packets[index++];
+                int textlen;
+                text = encryptor->Decrypt(packet.first.get(), packet.second, textlen);
+                return text && textlen == size;
+            });
+        decrypt.success = decrypt.success && memcmp(text.get(), data, size) == 0;
+    }
+    packets.clear();
+
+    PrintResult(method, size, "encrypt", encrypt);
+    PrintResult(method, size, "decrypt", decrypt);
+    if (!encryptor->SupportInPlace()) {
+        return;
+    }
+
+    Byte* p = buffer.get();
+    memcpy(p, data, size);
+
+    BenchmarkResult encrypt_in_place;
+    if (ResetEncryptor(*encryptor)) {
+        encrypt_in_place = Measure(iterations,
+            [encryptor, p, size]() noexcept {
+                return encryptor->EncryptInPlace(p, size, p + size) == size;
+            });
+    }
+
+    /* Each packet keeps its tag behind it, the run decrypts them where they lie. */
+    BenchmarkResult decrypt_in_place;
+    int tag_size = encryptor->GetTagSize();
+    int stride = size + tag_size;
+    std::shared_ptr<Byte> sealed = (int64_t)stride * count > INT32_MAX ? NULL : uds::make_shared_alloc<Byte>(stride * count);
+    if (sealed && ResetEncryptor(*encryptor)) {
+        Byte* q = sealed.get();
+        bool success = true;
+        for (int i = 0; i < count && success; i++) {
+            Byte* packet = q + i * stride;
+            memcpy(packet, data, size);
+            success = encryptor->EncryptInPlace(packet, size, packet + size) == size;
+        }
+
+        if (success) {
+            int index = 0;
+            decrypt_in_place = Measure(iterations,
+                [encryptor, q, &index, size, stride, tag_size]() noexcept {
+                    return encryptor->DecryptInPlace(q + (index++) * stride, size + tag_size) == size;
+                });
+            decrypt_in_place.success = decrypt_in_place.success && memcmp(q + (count - 1) * stride, data, size) == 0;
+        }
+    }
+
+    PrintResult(method, size, "encrypt-in-place", encrypt_in_place);
+    PrintResult(method, size, "decrypt-in-place", decrypt_in_place);
+}
+
+/* One name per cipher, the lower-case long name where it resolves since that is how configurations spell it. */
+static void GetAllMethods(std::vector<std::string>& methods) noexcept {
+    std::map<int, std::string> ciphers;
+    EVP_CIPHER_do_all_sorted(
+        [](const EVP_CIPHER* cipher, const char* from, const char* to, void* state) noexcept {
+            if (NULL == cipher || NULL == from) {
+                return;
+            }
+
+            std::map<int, std::string>& ciphers = *(std::map<int, std::string>*)state;
+            int nid = EVP_CIPHER_nid(cipher);
+            if (ciphers.find(nid) != ciphers.end()) {
+                return;
+            }
+
+            std::string name = uds::ToLower<std::string>(from);
+            const char* ln = OBJ_nid2ln(nid);
+            if (NULL != ln && EVP_get_cipherbyname(ln) == cipher) {
+                name = ln;
+            }
+            ciphers[nid] = name;
+        }, &ciphers);
+
+    for (std::map<int, std::string>::iterator tail = ciphers.begin(), endl = ciphers.end(); tail != endl; tail++) {
+        const std::string& method = tail->second;
+        if (Encryptor::Support(method)) {
+            methods.push_back(method);
+        }
+    }
+    std::sort(methods.begin(), methods.end());
+}
+
+static void Split(const std::string& line, std::vector<std::string>& tokens) noexcept {
+    std::size_t L = 0;
+    while (L <= line.size()) {
+        std::size_t R = line.find(',', L);
+        if (R == std::string::npos) {
+            R = line.size();
+        }
+
+        std::string token = line.substr(L, R - L);
+        if (!token.empty()) {
+            tokens.push_back(token);
+        }
+        L = R + 1;
+    }
+}
+
+int main(int argc, const char* argv[]) noexcept {
+    /* Must precede the first OpenSSL allocation. */
+    CRYPTO_set_mem_functions(OpenSSL_Malloc, OpenSSL_Realloc, OpenSSL_Free);
+    Encryptor::Initialize();
+
+    if (uds::IsInputHelpCommand(argc, argv)) {
+        fprintf(stdout, "Usage:\r\n    %s [-methods=aes-128-gcm,chacha20-poly1305] [-sizes=64,1024] [-bytes=4194304]\r\n", argv[0]);
+        return 0;
+    }
+
+    std::vector<std::string> methods;
+    Split(uds::GetCommandArgument("-methods", argc, argv), methods);
+    if (methods.empty()) {
+        GetAllMethods(methods);
+    }
+
+    const int max_size = Hosting::BufferSize;
+    std::vector<int> sizes;
+    {
+        std::vector<std::string> tokens;
+        Split(uds::GetCommandArgument("-sizes", argc, argv), tokens);
+        for (const std::string& token : tokens) {
+            int size = atoi(token.data());
+            if (size > 0 && size <= max_size) {
+                sizes.push_back(size);
+            }
+        }
+    }
+
+    if (sizes.empty()) {
+        for (int size = 64; size < max_size; size <<= 1) {
+            sizes.push_back(size);
+        }
+        sizes.push_back(max_size);
+    }
+
+    int64_t bytes = atoll(uds::GetCommandArgument("-bytes", argc, argv, "4194304").data());
+    if (bytes < 1) {
+        bytes = 4194304;
+    }
+
+    fprintf(stdout, "%-28s %8s  %-18s %12s %10s %10s\r\n", "method", "size", "operation", "ns/op", "GB/s", "allocs/op");
+    for (const std::string& method : methods) {
+        if (!Encryptor::Support(method)) {
+            fprintf(stdout, "%-28s %8s  %-18s %12s\r\n", method.data(), "-", "-", "unsupported");
+            continue;
+        }
+
+        for (int size : sizes) {
+            Benchmark(method, size, bytes);
+        }
+    }
+    return 0;
+}
@@ -98,8 +98,20 @@ int main(int argc, const char* argv[]) noexcept {
     uds::cryptography::Encryptor::Initialize(); /* Prepare the OpenSSL cryptography library environment. */
 
     std::shared_ptr<Hosting> hosting = Reference::NewReference<Hosting>();
-    hosting->Run(
+    hosting->OpenCryptoWorkers(configuration->Crypto.Concurrent);
+    hosting->Run(configuration->Concurrent,
         [configuration, hosting]() noexcept {
+            /* Ctrl+C or a termination request stops the main context, Run then stops and joins the other workers. */
+            std::shared_ptr<boost::asio::signal_set> signals = uds::make_shared_object<boost::asio::signal_set>(*hosting->GetContext(), SIGINT, SIGTERM);
+            if (signals) {
+                signals->async_wait(
+                    [signals, hosting](const boost::system::error_code& ec, int signo) noexcept {
+                        if (!ec) {
+                            hosting->Exit();
+                        }
+                    });
+            }
+
             auto protocol = [](AppConfiguration* config) noexcept {
                 switch (config->Protocol)
                 {
@@ -129,6 +141,8 @@ int main(int argc, const char* argv[]) noexcept {
                     fprintf(stdout, "Mode                  : %s\r\n", "server");
                     fprintf(stdout, "Process               : %d\r\n", uds::GetCurrentProcessId());
                     fprintf(stdout, "Protocol              : %s\r\n", protocol(configuration.get()));
+                    fprintf(stdout, "Concurrent            : %d\r\n", hosting->GetConcurrency());
+                    fprintf(stdout, "Crypto                : %d\r\n", hosting->GetCryptoConcurrency());
                     fprintf(stdout, "Cwd                   : %s\r\n", uds::GetCurrentDirectoryPath().data());
                     fprintf(stdout, "TCP/IP RX             : %s\r\n", IPEndPoint::ToEndPoint(server->GetLocalEndPoint(true)).ToString().data());
                     fprintf(stdout, "TCP/IP TX             : %s\r\n", IPEndPoint::ToEndPoint(server->GetLocalEndPoint(false)).ToString().data());
@@ -147,6 +161,8 @@ int main(int argc, const char* argv[]) noexcept {
                     fprintf(stdout, "Mode                  : %s\r\n", "client");
                     fprintf(stdout, "Process               : %d\r\n", uds::GetCurrentProcessId());
                     fprintf(stdout, "Protocol              : %s\r\n", protocol(configuration.get()));
+                    fprintf(stdout, "Concurrent            : %d\r\n", hosting->GetConcurrency());
+                    fprintf(stdout, "Crypto                : %d\r\n", hosting->GetCryptoConcurrency());
                     fprintf(stdout, "Cwd                   : %s\r\n", uds::GetCurrentDirectoryPath().data());
                     fprintf(stdout, "TCP/IP                : %s\r\n", IPEndPoint::ToEndPoint(client->GetLocalEndPoint()).ToString().data());
                 }
@@ -155,5 +171,6 @@ int main(int argc, const char* argv[]) noexcept {
                 }
             }
         });
+    fprintf(stdout, "Send queue peak       : %d\r\n", hosting->GetQueueHighWaterMark());
     return 0;
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <uds/stdafx.h>
+#include <random>
 
 namespace uds {
     struct Random {
@@ -110,4 +111,92 @@ namespace uds {
             return (int)((long long)(NextDouble() * (double)num) + minValue);
         }
     };
+
+    /* xoshiro256** seeded through splitmix64: four words of state and a handful of shifts per 64 bits of output, meant to be owned by one thread. */
+    struct FastRandom {
+    private:
+        uint64_t                            State[4];
+
+    public:
+        inline FastRandom() noexcept {
+            static std::atomic<uint64_t> sequence(0);
+            uint64_t seed = GetTickCount(true) ^ (uint64_t)(uintptr_t)this ^ (++sequence * 0x9E3779B97F4A7C15ULL);
+            try {
+                /* The clock and the address only stand in when the system entropy source cannot be opened. */
+                std::random_device device;
+                seed ^= ((uint64_t)device() << 32) | (uint64_t)device();
+            }
+            catch (std::exception&) {}
+            SetSeed(seed);
+        }
+        inline FastRandom(uint64_t seed) noexcept {
+            SetSeed(seed);
+        }
+
+    public:
+        inline void                         SetSeed(uint64_t seed) noexcept {
+            for (int i = 0; i < 4; i++) {
+                uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                State[i] = z ^ (z >> 31);
+            }
+        }
+
+    public:
+        inline uint64_t                     NextUInt64() noexcept {
+            uint64_t result = Rotl(State[1] * 5, 7) * 9;
+            uint64_t t = State[1] << 17;
+            State[2] ^= State[0];
+            State[3] ^= State[1];
+            State[1] ^= State[2];
+            State[0] ^= State[3];
+            State[2] ^= t;
+            State[3] = Rotl(State[3], 45);
+            return result;
+        }
+        inline int                          Next() noexcept {
+            return (int)(NextUInt64() >> 33);
+        }
+        inline double                       NextDouble() noexcept {
+            return (double)(NextUInt64() >> 11) * (1.0 / 9007199254740992.0);
+        }
+        inline int                          Next(int minValue, int maxValue) noexcept { /* Same contract as Random::Next(int, int): maxValue is exclusive. */
+            if (minValue >= maxValue) {
+                return minValue;
+            }
+
+            uint64_t range = (uint64_t)((int64_t)maxValue - (int64_t)minValue);
+            return (int)((int64_t)minValue + (int64_t)(((NextUInt64() >> 32) * range) >> 32));
+        }
+        inline void                         Fill(void* buffer, int length) noexcept {
+            Byte* p = (Byte*)buffer;
+            for (; length >= 8; p += 8, length -= 8) {
+                uint64_t value = NextUInt64();
+                memcpy(p, &value, 8);
+            }
+
+            if (length > 0) {
+                uint64_t value = NextUInt64();
+                memcpy(p, &value, length);
+            }
+        }
+        /* [0-9A-Za-z], four characters per 64 bits; each 16-bit lane is scaled onto the alphabet with a multiply instead of a division. */
+        inline void                         FillAscii(Char* buffer, int length) noexcept {
+            static const char alphabet[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+            static const uint32_t alphabet_size = sizeof(alphabet) - 1;
+
+            for (int i = 0; i < length;) {
+                uint64_t value = NextUInt64();
+                for (int lane = 0; lane < 4 && i < length; lane++, i++, value >>= 16) {
+                    buffer[i] = (Char)alphabet[((uint32_t)(value & 0xFFFF) * alphabet_size) >> 16];
+                }
+            }
+        }
+
+    private:
+        static inline uint64_t              Rotl(uint64_t x, int k) noexcept {
+            return (x << k) | (x >> (64 - k));
+        }
+    };
 }
\ No newline at end of file
@@ -17,6 +17,11 @@ using uds::net::Socket;
 using uds::net::IPEndPoint;
 using uds::net::AddressFamily;
 
+#ifndef _WIN32
+#include <errno.h>
+#include <sys/socket.h>
+#endif
+
 namespace uds {
     namespace client {
         Router::Router(const std::shared_ptr<uds::threading::Hosting>& hosting, const std::shared_ptr<uds::configuration::AppConfiguration>& configuration) noexcept
@@ -27,6 +32,11 @@ namespace uds {
             if (hosting) {
                 context_ = hosting->GetContext();
             }
+
+            /* Every transmission of this configuration shares one key derivation and clones its cipher contexts from it. */
+            if (configuration && configuration->Protocol == AppConfiguration::ProtocolType_Encryptor) {
+                encryptor_ = make_shared_object<uds::cryptography::EncryptorKey>(configuration->Protocols.Encryptor.Method, configuration->Protocols.Encryptor.Password);
+            }
         }
 
         bool Router::AddTimeout(void* key, std::shared_ptr<boost::asio::deadline_timer>&& timeout) noexcept {
@@ -37,7 +47,7 @@ namespace uds {
                 ClearTimeout(key);
             }
 
-            bool success = Dictionary::TryAdd(timeouts_, key, timeout);
+            bool success = timeouts_.TryAdd(key, timeout);
             if (!success) {
                 uds::threading::ClearTimeout(timeout);
             }
@@ -50,7 +60,7 @@ namespace uds {
             }
 
             TimeoutPtr timeout;
-            Dictionary::TryRemove(timeouts_, key, timeout);
+            timeouts_.TryRemove(key, timeout);
             return uds::threading::ClearTimeout(timeout);
         }
 
@@ -60,20 +70,25 @@ namespace uds {
                 CloseAcceptor();
 
                 /* Clear all timeouts. */
-                Dictionary::ReleaseAllPairs(timeouts_,
+                timeouts_.ReleaseAllPairs(
                     [](TimeoutPtr& timeout) noexcept {
                         uds::threading::Hosting::Cancel(timeout);
                     });
 
                 /* Close all connection. */
-                Dictionary::ReleaseAllPairs(connections_);
+                connections_.ReleaseAllPairs();
+
+                /* Close the idle legs still waiting in the pools, and the multiplexed leg pairs. */
+                ClosePool();
+                CloseMultiplexer();
             }
         }
 
         void Router::CloseAcceptor() noexcept {
-            std::shared_ptr<boost::asio::ip::tcp::acceptor>& acceptor = acceptor_;
-            if (acceptor) {
-                Socket::Closesocket(*acceptor);
+            for (AcceptorPtr& acceptor : acceptors_) {
+                if (acceptor) {
+                    Socket::Closesocket(*acceptor);
+                }
             }
 
             std::shared_ptr<boost::asio::ip::tcp::resolver>& resolver = resolver_;
@@ -84,10 +99,16 @@ namespace uds {
                 catch (std::exception&) {}
             }
 
-            acceptor.reset();
+            acceptors_.clear();
             resolver.reset();
         }
 
+        bool Router::OpenAcceptor(AcceptorList& acceptors, const uds::net::IPEndPoint& bindEP, const uds::net::Socket::AcceptLoopbackCallback&& loopback) noexcept {
+            boost::asio::ip::address address = IPEndPoint::ToEndPoint<boost::asio::ip::tcp>(bindEP).address();
+            return Socket::OpenAcceptor(hosting_, context_, acceptors, address, bindEP.Port,
+                configuration_->Backlog, configuration_->FastOpen, configuration_->Turbo, configuration_->ReusePort, forward0f(loopback));
+        }
+
         bool Router::Listen() noexcept {
             if (disposed_ || !hosting_ || !context_ || !configuration_) {
                 return false;
@@ -114,12 +135,31 @@ namespace uds {
                 }
             }
 
+            /* The pool table is filled before the first accept and never changes afterwards, the acceptors read it without a lock. */
+            if (configuration_->Multiplex.Enabled) {
+                if (!OpenMultiplexer()) {
+                    return false;
+                }
+            }
+            elif(configuration_->Pool.Size > 0 && !OpenPool()) {
+                return false;
+            }
+
             std::shared_ptr<Reference> references = GetReference();
-            acceptor_ = OpenAcceptor(localEP,
+            bool success = OpenAcceptor(acceptors_, localEP,
                 [references, this](const AsioContext& context, const AsioTcpSocket& socket) noexcept {
+                    if (configuration_->Multiplex.Enabled) {
+                        return MultiplexClient(context, socket);
+                    }
+                    elif(AcceptPooledClient(context, socket)) {
+                        return true;
+                    }
+                    elif(configuration_->Handshake.Parallel) {
+                        return ProposeClient(context, socket);
+                    }
                     return AcceptClient(context, socket);
                 });
-            if (acceptor_) {
+            if (success) {
                 resolver_ = make_shared_object<boost::asio::ip::tcp::resolver>(*context_);
                 return true;
             }
@@ -128,19 +168,34 @@ namespace uds {
             return false;
         }
 
-        bool Router::ResolveAddress(bool domain, const std::string& hostname, int port, ResolveAddressAsyncCallback&& callback) noexcept {
+        bool Router::ResolveAddress(const AsioContext& context, bool domain, const std::string& hostname, int port, ResolveAddressAsyncCallback&& callback) noexcept {
             if (domain) {
                 std::shared_ptr<Reference> references = GetReference();
                 ResolveAddressAsyncCallback scallback = callback;
-                Ipep::GetAddressByHostName(resolver_, hostname, port,
-                    make_shared_object<Ipep::GetAddressByHostNameCallback>(
-                        [scallback, references, this](IPEndPoint* ep) noexcept {
-                            boost::asio::ip::tcp::endpoint remoteEP;
-                            if (ep) {
-                                remoteEP = IPEndPoint::ToEndPoint<boost::asio::ip::tcp>(*ep);
-                            }
-                            scallback(remoteEP);
-                        }));
+                AsioContext scontext = context;
+
+                /* The resolver is shared and lives on the main context, complete on the worker context that requested the address. */
+                boost::asio::dispatch(*context_,
+                    [scontext, scallback, references, this, hostname, port]() noexcept {
+                        std::shared_ptr<boost::asio::ip::tcp::resolver> resolver = resolver_;
+                        if (!resolver) {
+                            return;
+                        }
+
+                        Ipep::GetAddressByHostName(resolver, hostname, port,
+                            make_shared_object<Ipep::GetAddressByHostNameCallback>(
+                                [scontext, scallback, references, this](IPEndPoint* ep) noexcept {
+                                    boost::asio::ip::tcp::endpoint remoteEP;
+                                    if (ep) {
+                                        remoteEP = IPEndPoint::ToEndPoint<boost::asio::ip::tcp>(*ep);
+                                    }
+
+                                    boost::asio::dispatch(*scontext,
+                                        [scallback, remoteEP]() noexcept {
+                                            scallback(remoteEP);
+                                        });
+                                }));
+                    });
                 return true;
             }
             else {
@@ -160,17 +215,17 @@ namespace uds {
             const std::shared_ptr<Reference> references = GetReference();
             const AsioTcpSocket network = socket;
             const AsioContext scontext = context;
-            const auto timeout = uds::threading::SetTimeout(hosting_,
+            const auto timeout = uds::threading::SetTimeout(scontext,
                 [network, references, this](void* key) noexcept {
                     Socket::Closesocket(network);
                 }, (UInt64)configuration_->Connect.Timeout * 1000);
 
-            return ResolveAddress(configuration_->Inbound.Domain, configuration_->Inbound.IP, configuration_->Inbound.Port,
+            return ResolveAddress(scontext, configuration_->Inbound.Domain, configuration_->Inbound.IP, configuration_->Inbound.Port,
                 [scontext, timeout, network, references, this](const boost::asio::ip::tcp::endpoint& remoteEP) noexcept {
                     if (!ConnectConnection(scontext, 0, remoteEP,
                         [timeout, network, references, this](const ITransmissionPtr& transmission, int channelId) noexcept {
                             const ITransmissionPtr inbound = transmission;
-                            return ResolveAddress(configuration_->Outbound.Domain, configuration_->Outbound.IP, configuration_->Outbound.Port,
+                            return ResolveAddress(inbound->GetContext(), configuration_->Outbound.Domain, configuration_->Outbound.IP, configuration_->Outbound.Port,
                                 [channelId, inbound, timeout, network, references, this](const boost::asio::ip::tcp::endpoint& remoteEP) noexcept {
                                     if (!ConnectConnection(inbound->GetContext(), channelId, remoteEP,
                                         [inbound, timeout, network, references, this](const ITransmissionPtr& outbound, int channelId) noexcept {
@@ -188,6 +243,702 @@ namespace uds {
                 });
         }
 
+        bool Router::ProposeClient(const AsioContext& context, const AsioTcpSocket& socket) noexcept {
+            ConnectionProposalPtr proposal = make_shared_object<ConnectionProposal>();
+            if (!proposal) {
+                return false;
+            }
+
+            /* Channel ids stay local to this side, only the token travels and pairs the legs on the server. */
+            proposal->channel_ = NewChannelId();
+            proposal->token_ = Connection::NewProposalToken();
+
+            const std::shared_ptr<Reference> references = GetReference();
+            const AsioTcpSocket network = socket;
+            const TimeoutPtr timeout = uds::threading::SetTimeout(context,
+                [network, proposal, references, this](void* key) noexcept {
+                    proposal->Close();
+                    Socket::Closesocket(network);
+                }, (UInt64)configuration_->Connect.Timeout * 1000);
+            if (!timeout) {
+                return false;
+            }
+
+            if (ProposeLeg(context, network, proposal, false, timeout) && ProposeLeg(context, network, proposal, true, timeout)) {
+                return true;
+            }
+
+            uds::threading::ClearTimeout(constantof(timeout));
+            proposal->Close();
+            return false;
+        }
+
+        bool Router::ProposeLeg(const AsioContext& context, const AsioTcpSocket& network, const ConnectionProposalPtr& proposal, bool outbound, const TimeoutPtr& timeout) noexcept {
+            const std::shared_ptr<Reference> references = GetReference();
+            const AsioContext scontext = context;
+            const AsioTcpSocket snetwork = network;
+            const ConnectionProposalPtr sproposal = proposal;
+            const TimeoutPtr stimeout = timeout;
+
+            /* Both legs complete on the context of the accepted socket, the proposal needs no lock. */
+            const bool domain = outbound ? configuration_->Outbound.Domain : configuration_->Inbound.Domain;
+            const std::string& hostname = outbound ? configuration_->Outbound.IP : configuration_->Inbound.IP;
+            const int port = outbound ? configuration_->Outbound.Port : configuration_->Inbound.Port;
+            return ResolveAddress(scontext, domain, hostname, port,
+                [scontext, snetwork, sproposal, stimeout, outbound, references, this](const boost::asio::ip::tcp::endpoint& remoteEP) noexcept {
+                    if (sproposal->closed_) {
+                        return;
+                    }
+
+                    bool success = ConnectConnection(scontext, sproposal->channel_, sproposal->token_, remoteEP,
+                        [snetwork, sproposal, stimeout, outbound, references, this](const ITransmissionPtr& transmission, int channelId) noexcept {
+                            if (sproposal->closed_) {
+                                return false;
+                            }
+
+                            ITransmissionPtr* legs = sproposal->legs_;
+                            legs[outbound ? 1 : 0] = transmission;
+                            if (!legs[0] || !legs[1]) {
+                                return true;
+                            }
+
+                            const ITransmissionPtr inbound_leg = std::move(legs[0]);
+                            const ITransmissionPtr outbound_leg = std::move(legs[1]);
+                            legs[0].reset();
+                            legs[1].reset();
+                            sproposal->closed_ = true;
+
+                            uds::threading::ClearTimeout(constantof(stimeout));
+                            if (Accept(snetwork, channelId, inbound_leg, outbound_leg)) {
+                                return true;
+                            }
+
+                            inbound_leg->Close();
+                            outbound_leg->Close();
+                            Socket::Closesocket(snetwork);
+                            return false;
+                        });
+                    if (!success) {
+                        uds::threading::ClearTimeout(constantof(stimeout));
+                        sproposal->Close();
+                        Socket::Closesocket(snetwork);
+                    }
+                });
+        }
+
+        int Router::NewChannelId() noexcept {
+            /* Only skips the ids in use, the id is reserved once Accept adds its connection. */
+            for (;;) {
+                int channelId = ++channel_ & INT32_MAX;
+                if (channelId && !connections_.ContainsKey(channelId)) {
+                    return channelId;
+                }
+            }
+        }
+
+        bool Router::AcceptPooledClient(const AsioContext& context, const AsioTcpSocket& socket) noexcept {
+            static const auto CloseAll = [](const AsioTcpSocket& network, const ITransmissionPtr& inbound, const ITransmissionPtr& outbound) noexcept {
+                inbound->Close();
+                outbound->Close();
+                Socket::Closesocket(network);
+            };
+
+            TransmissionPool::Leg legs[2];
+            if (!PopPool(context, legs)) {
+                return false;
+            }
+
+            const std::shared_ptr<Reference> references = GetReference();
+            const AsioTcpSocket network = socket;
+            const ITransmissionPtr inbound = legs[0].transmission;
+            const ITransmissionPtr outbound = legs[1].transmission;
+
+            /* Serial legs still owe the server the channel it gave the inbound one, parallel legs owe both the proposal. */
+            bool success = false;
+            if (configuration_->Handshake.Parallel) {
+                const int channelId = NewChannelId();
+                const Int64 token = Connection::NewProposalToken();
+                success = Connection::ProposeAsync(inbound, configuration_->Alignment, token,
+                    [references, this, network, inbound, outbound, channelId, token](bool success) noexcept {
+                        if (success) {
+                            success = Connection::ProposeAsync(outbound, configuration_->Alignment, token,
+                                [references, this, network, inbound, outbound, channelId](bool success) noexcept {
+                                    if (!success || !Accept(network, channelId, inbound, outbound)) {
+                                        CloseAll(network, inbound, outbound);
+                                    }
+                                });
+                        }
+
+                        if (!success) {
+                            CloseAll(network, inbound, outbound);
+                        }
+                    });
+            }
+            else {
+                success = Connection::ConnectAsync(outbound, configuration_->Alignment, legs[0].channel,
+                    [references, this, network, inbound, outbound](bool success, int channelId) noexcept {
+                        if (!success || !Accept(network, channelId, inbound, outbound)) {
+                            CloseAll(network, inbound, outbound);
+                        }
+                    });
+            }
+
+            /* The accepted socket is untouched on a synchronous failure, the caller dials it fresh legs. */
+            if (!success) {
+                inbound->Close();
+                outbound->Close();
+            }
+            return success;
+        }
+
+        bool Router::OpenPool() noexcept {
+            uds::threading::Hosting::ContextList contexts = hosting_->GetContexts();
+            if (contexts.empty()) {
+                contexts.push_back(context_);
+            }
+
+            /* Spread the configured size over the worker contexts, each keeps its share of pairs next to the sockets it accepts. */
+            int size = (configuration_->Pool.Size + (int)contexts.size() - 1) / (int)contexts.size();
+            for (const AsioContext& context : contexts) {
+                TransmissionPoolPtr pool = make_shared_object<TransmissionPool>();
+                if (!pool) {
+                    ClosePool();
+                    return false;
+                }
+
+                pool->size_ = size;
+                pool->context_ = context;
+                pools_[context.get()] = pool;
+            }
+
+            const std::shared_ptr<Reference> references = GetReference();
+            for (TransmissionPoolTable::iterator tail = pools_.begin(), endl = pools_.end(); tail != endl; tail++) {
+                const TransmissionPoolPtr pool = tail->second;
+                boost::asio::post(*pool->context_,
+                    [references, this, pool]() noexcept {
+                        NextPoolCycle(pool);
+                    });
+            }
+            return true;
+        }
+
+        void Router::ClosePool() noexcept {
+            for (TransmissionPoolTable::iterator tail = pools_.begin(), endl = pools_.end(); tail != endl; tail++) {
+                tail->second->Close();
+            }
+        }
+
+        void Router::TransmissionPool::Close() noexcept {
+            LegList legs[2];
+            TimeoutPtr timeout;
+            {
+                MutexScope scope(syncobj_);
+                closed_ = true;
+                timeout = std::move(timeout_);
+                for (int side = 0; side < 2; side++) {
+                    legs[side] = std::move(legs_[side]);
+                    legs_[side].clear();
+                }
+            }
+
+            uds::threading::ClearTimeout(timeout);
+            for (LegList& list : legs) {
+                for (Leg& leg : list) {
+                    leg.transmission->Close();
+                }
+            }
+        }
+
+        void Router::TransmissionDialing::Settle() noexcept {
+            if (!settled_.exchange(true) && pool_) {
+                TransmissionPool::MutexScope scope(pool_->syncobj_);
+                pool_->dialing_[side_]--;
+            }
+        }
+
+        /* A peer that gave up on an idle leg leaves a FIN or RST behind, TLS legs own their socket inside the stream and are judged by age alone. */
+        static bool Router_IsAlive(const std::shared_ptr<uds::transmission::ITransmission>& transmission) noexcept {
+#ifndef _WIN32
+            std::shared_ptr<uds::transmission::Transmission> transmission_ = Reference::AsReference<uds::transmission::Transmission>(transmission);
+            if (!transmission_) {
+                return true;
+            }
+
+            std::shared_ptr<boost::asio::ip::tcp::socket>& socket = transmission_->GetSocket();
+            if (!socket || !socket->is_open()) {
+                return true;
+            }
+
+            Byte b;
+            ssize_t n = recv(socket->native_handle(), &b, 1, MSG_PEEK | MSG_DONTWAIT);
+            if (n == 0) {
+                return false;
+            }
+            elif(n < 0) {
+                return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+            }
+#endif
+            return true;
+        }
+
+        bool Router::NextPoolCycle(const TransmissionPoolPtr& pool) noexcept {
+            std::vector<ITransmissionPtr> expired;
+            {
+                TransmissionPool::MutexScope scope(pool->syncobj_);
+                if (pool->closed_ || disposed_) {
+                    return false;
+                }
+
+                UInt64 now = GetTickCount();
+                for (TransmissionPool::LegList& list : pool->legs_) {
+                    for (TransmissionPool::LegList::iterator tail = list.begin(); tail != list.end();) {
+                        if (tail->expired > now && Router_IsAlive(tail->transmission)) {
+                            tail++;
+                        }
+                        else {
+                            expired.push_back(tail->transmission);
+                            tail = list.erase(tail);
+                        }
+                    }
+                }
+            }
+
+            for (const ITransmissionPtr& transmission : expired) {
+                transmission->Close();
+            }
+            FillPool(pool);
+
+            const std::shared_ptr<Reference> references = GetReference();
+            const TransmissionPoolPtr spool = pool;
+            TimeoutPtr timeout = uds::threading::SetTimeout(pool->context_,
+                [references, this, spool](void* key) noexcept {
+                    NextPoolCycle(spool);
+                }, 1000);
+            if (!timeout) {
+                return false;
+            }
+
+            TransmissionPool::MutexScope scope(pool->syncobj_);
+            if (pool->closed_) {
+                uds::threading::ClearTimeout(timeout);
+                return false;
+            }
+
+            pool->timeout_ = std::move(timeout);
+            return true;
+        }
+
+        void Router::FillPool(const TransmissionPoolPtr& pool) noexcept {
+            int needed[2] = { 0, 0 };
+            {
+                TransmissionPool::MutexScope scope(pool->syncobj_);
+                if (pool->closed_ || disposed_) {
+                    return;
+                }
+
+                for (int side = 0; side < 2; side++) {
+                    needed[side] = pool->size_ - (int)pool->legs_[side].size() - pool->dialing_[side];
+                    if (needed[side] > 0) {
+                        pool->dialing_[side] += needed[side];
+                    }
+                }
+            }
+
+            for (int side = 0; side < 2; side++) {
+                for (int i = 0; i < needed[side]; i++) {
+                    DialPool(pool, side);
+                }
+            }
+        }
+
+        bool Router::DialPool(const TransmissionPoolPtr& pool, int side) noexcept {
+            TransmissionDialingPtr dialing = make_shared_object<TransmissionDialing>();
+            if (!dialing) {
+                TransmissionPool::MutexScope scope(pool->syncobj_);
+                pool->dialing_[side]--;
+                return false;
+            }
+
+            dialing->pool_ = pool;
+            dialing->side_ = side;
+
+            /* A serial inbound leg is taken through the channel handshake now, the server hands out its channel before anything is written. */
+            const std::shared_ptr<Reference> references = GetReference();
+            const AsioContext context = pool->context_;
+            const bool outbound = side != 0;
+            const bool domain = outbound ? configuration_->Outbound.Domain : configuration_->Inbound.Domain;
+            const std::string& hostname = outbound ? configuration_->Outbound.IP : configuration_->Inbound.IP;
+            const int port = outbound ? configuration_->Outbound.Port : configuration_->Inbound.Port;
+            return ResolveAddress(context, domain, hostname, port,
+                [references, this, context, dialing, outbound](const boost::asio::ip::tcp::endpoint& remoteEP) noexcept {
+                    const TransmissionDialingPtr sdialing = dialing;
+                    if (!outbound && !configuration_->Handshake.Parallel) {
+                        ConnectConnection(context, 0, remoteEP,
+                            [references, this, sdialing](const ITransmissionPtr& transmission, int channelId) noexcept {
+                                sdialing->Settle();
+                                return PushPool(sdialing->pool_, sdialing->side_, transmission, channelId);
+                            });
+                    }
+                    else {
+                        ConnectTransmission(context, remoteEP,
+                            [references, this, sdialing](const ITransmissionPtr& transmission) noexcept {
+                                sdialing->Settle();
+                                return PushPool(sdialing->pool_, sdialing->side_, transmission, 0);
+                            });
+                    }
+                });
+        }
+
+        bool Router::PushPool(const TransmissionPoolPtr& pool, int side, const ITransmissionPtr& transmission, int channel) noexcept {
+            TransmissionPool::Leg leg;
+            leg.transmission = transmission;
+            leg.channel = channel;
+            leg.expired = GetTickCount() + (UInt64)configuration_->Pool.Idle * 1000;
+
+            TransmissionPool::MutexScope scope(pool->syncobj_);
+            if (pool->closed_ || disposed_) {
+                return false;
+            }
+
+            pool->legs_[side].push_back(leg);
+            return true;
+        }
+
+        bool Router::PopPool(const AsioContext& context, TransmissionPool::Leg (&legs)[2]) noexcept {
+            TransmissionPoolTable::iterator tail = pools_.find(context.get());
+            if (tail == pools_.end()) {
+                return false;
+            }
+
+            const TransmissionPoolPtr pool = tail->second;
+            std::vector<ITransmissionPtr> expired;
+            bool success = false;
+            {
+                TransmissionPool::MutexScope scope(pool->syncobj_);
+                if (pool->closed_) {
+                    return false;
+                }
+
+                /* Oldest first, a leg is drawn well before the server would give up on it. */
+                UInt64 now = GetTickCount();
+                for (TransmissionPool::LegList& list : pool->legs_) {
+                    while (!list.empty()) {
+                        TransmissionPool::Leg& leg = list.front();
+                        if (leg.expired > now && Router_IsAlive(leg.transmission)) {
+                            break;
+                        }
+
+                        expired.push_back(leg.transmission);
+                        list.pop_front();
+                    }
+                }
+
+                if (!pool->legs_[0].empty() && !pool->legs_[1].empty()) {
+                    for (int side = 0; side < 2; side++) {
+                        legs[side] = pool->legs_[side].front();
+                        pool->legs_[side].pop_front();
+                    }
+                    success = true;
+                }
+            }
+
+            for (const ITransmissionPtr& transmission : expired) {
+                transmission->Close();
+            }
+
+            /* Refill behind the accept rather than in front of it. */
+            if (success || expired.size()) {
+                const std::shared_ptr<Reference> references = GetReference();
+                boost::asio::post(*pool->context_,
+                    [references, this, pool]() noexcept {
+                        FillPool(pool);
+                    });
+            }
+            return success;
+        }
+
+        bool Router::OpenMultiplexer() noexcept {
+            uds::threading::Hosting::ContextList contexts = hosting_->GetContexts();
+            if (contexts.empty()) {
+                contexts.push_back(context_);
+            }
+
+            /* One leg pair per worker context, dialed by the first socket that context accepts. */
+            for (const AsioContext& context : contexts) {
+                MultiplexerSlotPtr slot = make_shared_object<MultiplexerSlot>();
+                if (!slot) {
+                    CloseMultiplexer();
+                    return false;
+                }
+
+                slot->context_ = context;
+                multiplexers_[context.get()] = slot;
+            }
+            return true;
+        }
+
+        void Router::CloseMultiplexer() noexcept {
+            for (MultiplexerSlotTable::iterator tail = multiplexers_.begin(), endl = multiplexers_.end(); tail != endl; tail++) {
+                tail->second->Close();
+            }
+        }
+
+        void Router::MultiplexerSlot::Close() noexcept {
+            MultiplexerPtr multiplexer;
+            std::vector<AsioTcpSocket> sockets;
+            {
+                MutexScope scope(syncobj_);
+                closed_ = true;
+                multiplexer = std::move(multiplexer_);
+                multiplexer_.reset();
+                sockets.swap(sockets_);
+            }
+
+            if (multiplexer) {
+                multiplexer->Close();
+            }
+
+            for (const AsioTcpSocket& socket : sockets) {
+                Socket::Closesocket(socket);
+            }
+        }
+
+        bool Router::MultiplexClient(const AsioContext& context, const AsioTcpSocket& socket) noexcept {
+            MultiplexerSlotTable::iterator tail = multiplexers_.find(context.get());
+            if (tail == multiplexers_.end()) {
+                return false;
+            }
+
+            const MultiplexerSlotPtr slot = tail->second;
+            MultiplexerPtr multiplexer;
+            bool connecting = false;
+            {
+                MultiplexerSlot::MutexScope scope(slot->syncobj_);
+                if (slot->closed_) {
+                    return false;
+                }
+
+                multiplexer = slot->multiplexer_;
+                if (!multiplexer) {
+                    slot->sockets_.push_back(socket);
+                    if (!slot->connecting_) {
+                        slot->connecting_ = true;
+                        connecting = true;
+                    }
+                }
+            }
+
+            if (multiplexer) {
+                return OpenStream(multiplexer, socket);
+            }
+            elif(connecting) {
+                ConnectMultiplexer(slot);
+            }
+            return true;
+        }
+
+        bool Router::OpenStream(const MultiplexerPtr& multiplexer, const AsioTcpSocket& socket) noexcept {
+            const AsioContext context = multiplexer->GetContext();
+            if (!context) {
+                return false;
+            }
+
+            /* Streams are opened on the context of their multiplexer, which is also the one the socket was accepted on. */
+            const std::shared_ptr<Reference> references = GetReference();
+            const MultiplexerPtr smultiplexer = multiplexer;
+            const AsioTcpSocket network = socket;
+            const int channelId = NewChannelId();
+            boost::asio::dispatch(*context,
+                [references, this, smultiplexer, network, channelId]() noexcept {
+                    ITransmissionPtr stream = smultiplexer->Open(channelId);
+                    if (stream && Accept(network, channelId, stream, stream)) {
+                        return;
+                    }
+
+                    if (stream) {
+                        stream->Close();
+                    }
+                    Socket::Closesocket(network);
+                });
+            return true;
+        }
+
+        bool Router::ConnectMultiplexer(const MultiplexerSlotPtr& slot) noexcept {
+            ConnectionProposalPtr proposal = make_shared_object<ConnectionProposal>();
+            if (!proposal) {
+                AbortMultiplexer(slot);
+                return false;
+            }
+
+            const std::shared_ptr<Reference> references = GetReference();
+            const MultiplexerSlotPtr sslot = slot;
+            const AsioContext context = slot->context_;
+            const TimeoutPtr timeout = uds::threading::SetTimeout(context,
+                [references, this, sslot, proposal](void* key) noexcept {
+                    proposal->Close();
+                    AbortMultiplexer(sslot);
+                }, (UInt64)configuration_->Connect.Timeout * 1000);
+            if (!timeout) {
+                AbortMultiplexer(slot);
+                return false;
+            }
+
+            /* The legs are dialed like those of a single connection, both complete on the context of the slot. */
+            const auto established = [references, this, sslot, proposal, timeout](int channelId) noexcept -> bool {
+                ITransmissionPtr* legs = proposal->legs_;
+                if (proposal->closed_ || !legs[0] || !legs[1]) {
+                    return !proposal->closed_;
+                }
+
+                const ITransmissionPtr inbound = std::move(legs[0]);
+                const ITransmissionPtr outbound = std::move(legs[1]);
+                legs[0].reset();
+                legs[1].reset();
+                proposal->closed_ = true;
+
+                uds::threading::ClearTimeout(constantof(timeout));
+                if (EstablishMultiplexer(sslot, channelId, inbound, outbound)) {
+                    return true;
+                }
+
+                inbound->Close();
+                outbound->Close();
+                AbortMultiplexer(sslot);
+                return false;
+            };
+
+            bool success = false;
+            if (configuration_->Handshake.Parallel) {
+                proposal->channel_ = NewChannelId();
+                proposal->token_ = Connection::NewProposalToken();
+
+                success = true;
+                for (int side = 0; side < 2 && success; side++) {
+                    const bool outbound = side != 0;
+                    const bool domain = outbound ? configuration_->Outbound.Domain : configuration_->Inbound.Domain;
+                    const std::string& hostname = outbound ? configuration_->Outbound.IP : configuration_->Inbound.IP;
+                    const int port = outbound ? configuration_->Outbound.Port : configuration_->Inbound.Port;
+                    success = ResolveAddress(context, domain, hostname, port,
+                        [references, this, context, proposal, established, side](const boost::asio::ip::tcp::endpoint& remoteEP) noexcept {
+                            if (proposal->closed_) {
+                                return;
+                            }
+
+                            ConnectConnection(context, proposal->channel_, proposal->token_, remoteEP,
+                                [proposal, established, side](const ITransmissionPtr& transmission, int channelId) noexcept {
+                                    if (proposal->closed_) {
+                                        return false;
+                                    }
+
+                                    proposal->legs_[side] = transmission;
+                                    return established(channelId);
+                                });
+                        });
+                }
+            }
+            else {
+                success = ResolveAddress(context, configuration_->Inbound.Domain, configuration_->Inbound.IP, configuration_->Inbound.Port,
+                    [references, this, context, proposal, established](const boost::asio::ip::tcp::endpoint& remoteEP) noexcept {
+                        ConnectConnection(context, 0, remoteEP,
+                            [references, this, context, proposal, established](const ITransmissionPtr& inbound, int channelId) noexcept {
+                                if (proposal->closed_) {
+                                    return false;
+                                }
+
+                                proposal->legs_[0] = inbound;
+                                return ResolveAddress(context, configuration_->Outbound.Domain, configuration_->Outbound.IP, configuration_->Outbound.Port,
+                                    [context, proposal, established, channelId, references, this](const boost::asio::ip::tcp::endpoint& remoteEP) noexcept {
+                                        ConnectConnection(context, channelId, remoteEP,
+                                            [proposal, established](const ITransmissionPtr& outbound, int channelId) noexcept {
+                                                if (proposal->closed_) {
+                                                    return false;
+                                                }
+
+                                                proposal->legs_[1] = outbound;
+                                                return established(channelId);
+                                            });
+                                    });
+                            });
+                    });
+            }
+
+            if (!success) {
+                uds::threading::ClearTimeout(constantof(timeout));
+                proposal->Close();
+                AbortMultiplexer(slot);
+            }
+            return success;
+        }
+
+        bool Router::EstablishMultiplexer(const MultiplexerSlotPtr& slot, int channel, const ITransmissionPtr& inbound, const ITransmissionPtr& outbound) noexcept {
+            /* CHANNEL: C <-> S: RX(outbound) <-> TX(inbound), as for a single connection. */
+            MultiplexerPtr multiplexer = NewReference<Multiplexer>(configuration_, channel, outbound, inbound);
+            if (!multiplexer) {
+                return false;
+            }
+
+            const std::shared_ptr<Reference> references = GetReference();
+            const MultiplexerSlotPtr sslot = slot;
+            multiplexer->DisposedEvent = [references, this, sslot](Multiplexer* multiplexer) noexcept {
+                MultiplexerSlot::MutexScope scope(sslot->syncobj_);
+                if (sslot->multiplexer_.get() == multiplexer) {
+                    sslot->multiplexer_.reset();
+                }
+            };
+            if (!multiplexer->Listen()) {
+                multiplexer->Close();
+                return false;
+            }
+
+            bool installed = false;
+            std::vector<AsioTcpSocket> sockets;
+            {
+                MultiplexerSlot::MutexScope scope(slot->syncobj_);
+                slot->connecting_ = false;
+                if (!slot->closed_ && multiplexer->Available()) {
+                    installed = true;
+                    slot->multiplexer_ = multiplexer;
+                    sockets.swap(slot->sockets_);
+                }
+            }
+
+            if (!installed) {
+                multiplexer->Close();
+                return false;
+            }
+
+            for (const AsioTcpSocket& socket : sockets) {
+                if (!OpenStream(multiplexer, socket)) {
+                    Socket::Closesocket(socket);
+                }
+            }
+            return true;
+        }
+
+        void Router::AbortMultiplexer(const MultiplexerSlotPtr& slot) noexcept {
+            std::vector<AsioTcpSocket> sockets;
+            {
+                MultiplexerSlot::MutexScope scope(slot->syncobj_);
+                slot->connecting_ = false;
+                sockets.swap(slot->sockets_);
+            }
+
+            for (const AsioTcpSocket& socket : sockets) {
+                Socket::Closesocket(socket);
+            }
+        }
+
+        void Router::ConnectionProposal::Close() noexcept {
+            closed_ = true;
+            for (ITransmissionPtr& leg : legs_) {
+                ITransmissionPtr transmission = std::move(leg);
+                if (transmission) {
+                    leg.reset();
+                    transmission->Close();
+                }
+            }
+        }
+
         bool Router::Accept(const AsioTcpSocket& network, int channel, const ITransmissionPtr& inbound, const ITransmissionPtr& outbound) noexcept {
             if (!network || !inbound || !outbound || !channel) {
                 return false;
@@ -195,31 +946,44 @@ namespace uds {
 
             /* CHANNEL: C <-> S: RX(outbound) <-> TX(inbound). */
             ConnectionPtr connection = CreateConnection(channel, outbound, inbound);
-            if (connection) {
-                std::shared_ptr<Reference> references = GetReference();
-                connection->DisposedEvent = [references, this](Connection* connection) noexcept {
-                    Dictionary::TryRemove(connections_, connection->Id);
-                };
-                if (connection->Listen(network)) {
-                    if (Dictionary::TryAdd(connections_, channel, connection)) {
-                        return true;
-                    }
-                }
-                connection->Close();
+            if (!connection) {
+                return false;
+            }
+
+            /* The id is claimed before anything can dispose the connection, a taken id fails this tunnel and leaves its owner alone. */
+            if (!connections_.TryAdd(channel, connection)) {
+                return false;
+            }
+
+            std::shared_ptr<Reference> references = GetReference();
+            connection->DisposedEvent = [references, this](Connection* connection) noexcept {
+                connections_.TryRemoveIf(connection->Id,
+                    [connection](const ConnectionPtr& p) noexcept {
+                        return p.get() == connection;
+                    });
+            };
+            if (connection->Listen(network)) {
+                return true;
             }
+
+            connection->Close();
             return false;
         }
 
         bool Router::ConnectConnection(const AsioContext& context, int channelId, const boost::asio::ip::tcp::endpoint& remoteEP, ConnectConnectionAsyncCallback&& callback) noexcept {
+            return ConnectConnection(context, channelId, 0, remoteEP, std::forward<ConnectConnectionAsyncCallback>(callback));
+        }
+
+        bool Router::ConnectConnection(const AsioContext& context, int channelId, Int64 token, const boost::asio::ip::tcp::endpoint& remoteEP, ConnectConnectionAsyncCallback&& callback) noexcept {
             const std::shared_ptr<Reference> references = GetReference();
             const ConnectConnectionAsyncCallback scallback = callback;
 
             return ConnectTransmission(context, remoteEP,
-                [channelId, scallback, references, this](const ITransmissionPtr& transmission) noexcept {
+                [channelId, token, scallback, references, this](const ITransmissionPtr& transmission) noexcept {
                     using ConnectAsyncCallback = Connection::ConnectAsyncCallback;
 
                     ITransmissionPtr transmission_ = transmission;
-                    if (!AddTimeout(transmission_.get(), uds::threading::SetTimeout(hosting_,
+                    if (!AddTimeout(transmission_.get(), uds::threading::SetTimeout(transmission_->GetContext(),
                         [references, this, transmission_](void* key) noexcept {
                             ClearTimeout(key);
                             transmission_->Close();
@@ -239,7 +1003,13 @@ namespace uds {
                     };
 
                     bool success = false;
-                    if (channelId) {
+                    if (token) {
+                        success = Connection::ProposeAsync(transmission, configuration_->Alignment, token,
+                            [f, channelId](bool success) noexcept {
+                                f(success, channelId);
+                            });
+                    }
+                    elif(channelId) {
                         success = Connection::ConnectAsync(transmission, configuration_->Alignment, channelId, std::forward<ConnectAsyncCallback>(f));
                     }
                     else {
@@ -290,7 +1060,7 @@ namespace uds {
             const std::shared_ptr<Reference> references = GetReference();
             const ConnectClientAsyncCallback scallback = callback;
 
-            if (!AddTimeout(network.get(), uds::threading::SetTimeout(hosting_,
+            if (!AddTimeout(network.get(), uds::threading::SetTimeout(context,
                 [references, this, network](void* key) noexcept {
                     ClearTimeout(key);
                     Socket::Closesocket(*network);
@@ -315,26 +1085,6 @@ namespace uds {
             return true;
         }
 
-        std::shared_ptr<boost::asio::ip::tcp::acceptor> Router::OpenAcceptor(const uds::net::IPEndPoint& bindEP, const uds::net::Socket::AcceptLoopbackCallback&& loopback) noexcept {
-            int listenPort = bindEP.Port;
-            if (listenPort < IPEndPoint::MinPort || listenPort > IPEndPoint::MaxPort) {
-                listenPort = IPEndPoint::MinPort;
-            }
-
-            boost::asio::ip::address address = IPEndPoint::ToEndPoint<boost::asio::ip::tcp>(bindEP).address();
-            std::shared_ptr<boost::asio::ip::tcp::acceptor> acceptor = NewReference<boost::asio::ip::tcp::acceptor>(*context_);
-            if (!Socket::OpenAcceptor(*acceptor, address, listenPort, configuration_->Backlog, configuration_->FastOpen, configuration_->Turbo)) {
-                Socket::Closesocket(*acceptor);
-                return NULL;
-            }
-
-            if (!Socket::AcceptLoopbackAsync(hosting_, acceptor, BOOST_ASIO_MOVE_CAST(Socket::AcceptLoopbackCallback)(constantof(loopback)))) {
-                Socket::Closesocket(*acceptor);
-                return NULL;
-            }
-            return std::move(acceptor);
-        }
-
         const std::shared_ptr<boost::asio::io_context>& Router::GetContext() noexcept {
             return context_;
         }
@@ -348,8 +1098,8 @@ namespace uds {
         }
 
         const boost::asio::ip::tcp::endpoint Router::GetLocalEndPoint() noexcept {
-            std::shared_ptr<boost::asio::ip::tcp::acceptor> acceptor = acceptor_;
-            if (acceptor) {
+            if (acceptors_.size()) {
+                const AcceptorPtr& acceptor = acceptors_.front();
                 boost::system::error_code ec;
                 return acceptor->local_endpoint(ec);
             }
@@ -365,7 +1115,7 @@ namespace uds {
             const std::shared_ptr<uds::transmission::ITransmission> network = transmission;
             const HandshakeAsyncCallback scallback = callback;
 
-            if (!AddTimeout(network.get(), uds::threading::SetTimeout(hosting_,
+            if (!AddTimeout(network.get(), uds::threading::SetTimeout(network->GetContext(),
                 [reference, this, network, scallback](void* key) noexcept {
                     ClearTimeout(key);
                     network->Close();
@@ -413,18 +1163,15 @@ namespace uds {
             if (configuration_->Protocol == AppConfiguration::ProtocolType_SSL ||
                 configuration_->Protocol == AppConfiguration::ProtocolType_TLS) {
                 transmission = NewReference2<uds::transmission::ITransmission, uds::transmission::SslSocketTransmission>(hosting_, context, socket,
+                    configuration_->Protocols.Ssl.VerifyPeer,
                     configuration_->Protocols.Ssl.Host,
-                    configuration_->Protocols.Ssl.CertificateFile,
-                    configuration_->Protocols.Ssl.CertificateKeyFile,
-                    configuration_->Protocols.Ssl.CertificateChainFile,
-                    configuration_->Protocols.Ssl.CertificateKeyPassword,
                     configuration_->Protocols.Ssl.Ciphersuites,
+                    configuration_->Protocols.Ssl.GetOptions(),
                     configuration_->Alignment);
             }
             elif(configuration_->Protocol == AppConfiguration::ProtocolType_Encryptor) {
                 transmission = NewReference2<uds::transmission::ITransmission, uds::transmission::EncryptorTransmission>(hosting_, context, socket,
-                    configuration_->Protocols.Encryptor.Method,
-                    configuration_->Protocols.Encryptor.Password,
+                    encryptor_,
                     configuration_->Alignment);
             }
             elif(configuration_->Protocol == AppConfiguration::ProtocolType_WebSocket) {
@@ -436,18 +1183,21 @@ namespace uds {
             elif(configuration_->Protocol == AppConfiguration::ProtocolType_WebSocket_SSL ||
                 configuration_->Protocol == AppConfiguration::ProtocolType_WebSocket_TLS) {
                 transmission = NewReference2<uds::transmission::ITransmission, uds::transmission::SslWebSocketTransmission>(hosting_, context, socket,
+                    configuration_->Protocols.Ssl.VerifyPeer,
                     configuration_->Protocols.WebSocket.Host,
                     configuration_->Protocols.WebSocket.Path,
-                    configuration_->Protocols.Ssl.CertificateFile,
-                    configuration_->Protocols.Ssl.CertificateKeyFile,
-                    configuration_->Protocols.Ssl.CertificateChainFile,
-                    configuration_->Protocols.Ssl.CertificateKeyPassword,
                     configuration_->Protocols.Ssl.Ciphersuites,
+                    configuration_->Protocols.Ssl.GetOptions(),
                     configuration_->Alignment);
             }
             else {
                 transmission = NewReference2<uds::transmission::ITransmission, uds::transmission::Transmission>(hosting_, context, socket, configuration_->Alignment);
             }
+
+            std::shared_ptr<uds::transmission::Transmission> transmission_ = AsReference<uds::transmission::Transmission>(transmission);
+            if (transmission_) {
+                transmission_->SetCoalescing(configuration_->Coalescing);
+            }
             return transmission->Constructor(transmission);
         }
     }
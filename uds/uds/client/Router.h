@@ -1,11 +1,14 @@
 #pragma once
 
 #include <uds/IDisposable.h>
+#include <uds/collections/ConcurrentDictionary.h>
 #include <uds/threading/Hosting.h>
 #include <uds/configuration/AppConfiguration.h>
+#include <uds/cryptography/EncryptorKey.h>
 #include <uds/net/Socket.h>
 #include <uds/net/IPEndPoint.h>
 #include <uds/tunnel/Connection.h>
+#include <uds/tunnel/Multiplexer.h>
 #include <uds/transmission/ITransmission.h>
 
 namespace uds {
@@ -19,14 +22,93 @@ namespace uds {
             using AppConfiguration                                              = uds::configuration::AppConfiguration;
             using HandshakeAsyncCallback                                        = std::function<void(const ITransmissionPtr&, bool)>;
             using TimeoutPtr                                                    = std::shared_ptr<boost::asio::deadline_timer>;
-            using TimeoutTable                                                  = std::unordered_map<void*, TimeoutPtr>;
+            using TimeoutTable                                                  = uds::collections::ConcurrentDictionary<void*, TimeoutPtr>;
             using Connection                                                    = uds::tunnel::Connection;
             using ConnectionPtr                                                 = std::shared_ptr<Connection>;
-            using ConnectionTable                                               = std::unordered_map<int, ConnectionPtr>;
+            using ConnectionTable                                               = uds::collections::ConcurrentDictionary<int, ConnectionPtr>;
+            using Multiplexer                                                   = uds::tunnel::Multiplexer;
+            using MultiplexerPtr                                                = std::shared_ptr<Multiplexer>;
             using ConnectClientAsyncCallback                                    = std::function<bool(const std::shared_ptr<boost::asio::ip::tcp::socket>&, bool)>;
             using ConnectTransmissionAsyncCallback                              = std::function<bool(const ITransmissionPtr&)>;
             using ConnectConnectionAsyncCallback                                = std::function<bool(const ITransmissionPtr&, int)>;
             using ResolveAddressAsyncCallback                                   = std::function<void(const boost::asio::ip::tcp::endpoint&)>;
+            using AcceptorPtr                                                   = std::shared_ptr<boost::asio::ip::tcp::acceptor>;
+            using AcceptorList                                                  = std::vector<AcceptorPtr>;
+
+        private:
+            /* Both legs of one client proposed channel, dialed together on the worker context of the accepted socket. */
+            class ConnectionProposal final {
+            public:
+                int                                                             channel_ = 0;
+                Int64                                                           token_ = 0;
+                bool                                                            closed_ = false;
+                ITransmissionPtr                                                legs_[2];
+
+            public:
+                void                                                            Close() noexcept;
+            };
+            using ConnectionProposalPtr                                         = std::shared_ptr<ConnectionProposal>;
+
+            /* Idle legs already through the transport handshake, one pool per worker context so a drawn pair lives next to the accepted socket. */
+            class TransmissionPool final {
+            public:
+                struct Leg {
+                    ITransmissionPtr                                            transmission;
+                    int                                                         channel = 0;
+                    UInt64                                                      expired = 0;
+                };
+                using LegList                                                   = std::deque<Leg>;
+                using MutexScope                                                = std::lock_guard<std::mutex>;
+
+            public:
+                std::mutex                                                      syncobj_;
+                bool                                                            closed_ = false;
+                int                                                             size_ = 0;
+                AsioContext                                                     context_;
+                TimeoutPtr                                                      timeout_;
+                LegList                                                         legs_[2];
+                int                                                             dialing_[2] = { 0, 0 };
+
+            public:
+                void                                                            Close() noexcept;
+            };
+            using TransmissionPoolPtr                                           = std::shared_ptr<TransmissionPool>;
+
+            /* One dial counted against a pool, settled once by the pushed leg or by the last handler of a dial that produced none. */
+            class TransmissionDialing final {
+            public:
+                TransmissionPoolPtr                                             pool_;
+                int                                                             side_ = 0;
+                std::atomic<bool>                                               settled_;
+
+            public:
+                TransmissionDialing() noexcept : settled_(false) {}
+                ~TransmissionDialing() noexcept { Settle(); }
+
+            public:
+                void                                                            Settle() noexcept;
+            };
+            using TransmissionDialingPtr                                        = std::shared_ptr<TransmissionDialing>;
+            using TransmissionPoolTable                                         = std::unordered_map<boost::asio::io_context*, TransmissionPoolPtr>;
+
+            /* The leg pair a worker context multiplexes its sockets over, and the sockets accepted while it is still being dialed. */
+            class MultiplexerSlot final {
+            public:
+                using MutexScope                                                = std::lock_guard<std::mutex>;
+
+            public:
+                std::mutex                                                      syncobj_;
+                bool                                                            closed_ = false;
+                bool                                                            connecting_ = false;
+                AsioContext                                                     context_;
+                MultiplexerPtr                                                  multiplexer_;
+                std::vector<AsioTcpSocket>                                      sockets_;
+
+            public:
+                void                                                            Close() noexcept;
+            };
+            using MultiplexerSlotPtr                                            = std::shared_ptr<MultiplexerSlot>;
+            using MultiplexerSlotTable                                          = std::unordered_map<boost::asio::io_context*, MultiplexerSlotPtr>;
 
         public:
             Router(const std::shared_ptr<uds::threading::Hosting>& hosting, const std::shared_ptr<uds::configuration::AppConfiguration>& configuration) noexcept;
@@ -46,15 +128,38 @@ namespace uds {
             bool                                                                AddTimeout(void* key, std::shared_ptr<boost::asio::deadline_timer>&& timeout) noexcept;
 
         private:
-            std::shared_ptr<boost::asio::ip::tcp::acceptor>                     OpenAcceptor(const uds::net::IPEndPoint& bindEP, const uds::net::Socket::AcceptLoopbackCallback&& loopback) noexcept;
+            bool                                                                OpenPool() noexcept;
+            void                                                                ClosePool() noexcept;
+            bool                                                                NextPoolCycle(const TransmissionPoolPtr& pool) noexcept;
+            void                                                                FillPool(const TransmissionPoolPtr& pool) noexcept;
+            bool                                                                DialPool(const TransmissionPoolPtr& pool, int side) noexcept;
+            bool                                                                PushPool(const TransmissionPoolPtr& pool, int side, const ITransmissionPtr& transmission, int channel) noexcept;
+            bool                                                                PopPool(const AsioContext& context, TransmissionPool::Leg (&legs)[2]) noexcept;
+            int                                                                 NewChannelId() noexcept;
+
+        private:
+            bool                                                                OpenMultiplexer() noexcept;
+            void                                                                CloseMultiplexer() noexcept;
+            bool                                                                ConnectMultiplexer(const MultiplexerSlotPtr& slot) noexcept;
+            bool                                                                EstablishMultiplexer(const MultiplexerSlotPtr& slot, int channel, const ITransmissionPtr& inbound, const ITransmissionPtr& outbound) noexcept;
+            void                                                                AbortMultiplexer(const MultiplexerSlotPtr& slot) noexcept;
+
+        private:
+            bool                                                                OpenAcceptor(AcceptorList& acceptors, const uds::net::IPEndPoint& bindEP, const uds::net::Socket::AcceptLoopbackCallback&& loopback) noexcept;
             void                                                                CloseAcceptor() noexcept;
 
         private:
             bool                                                                AcceptClient(const AsioContext& context, const AsioTcpSocket& socket) noexcept;
+            bool                                                                ProposeClient(const AsioContext& context, const AsioTcpSocket& socket) noexcept;
+            bool                                                                AcceptPooledClient(const AsioContext& context, const AsioTcpSocket& socket) noexcept;
+            bool                                                                MultiplexClient(const AsioContext& context, const AsioTcpSocket& socket) noexcept;
+            bool                                                                OpenStream(const MultiplexerPtr& multiplexer, const AsioTcpSocket& socket) noexcept;
+            bool                                                                ProposeLeg(const AsioContext& context, const AsioTcpSocket& network, const ConnectionProposalPtr& proposal, bool outbound, const TimeoutPtr& timeout) noexcept;
             bool                                                                ConnectClient(const AsioContext& context, const boost::asio::ip::tcp::endpoint& remoteEP, ConnectClientAsyncCallback&& callback) noexcept;
             bool                                                                ConnectTransmission(const AsioContext& context, const boost::asio::ip::tcp::endpoint& remoteEP, ConnectTransmissionAsyncCallback&& callback) noexcept;
             bool                                                                ConnectConnection(const AsioContext& context, int channelId, const boost::asio::ip::tcp::endpoint& remoteEP, ConnectConnectionAsyncCallback&& callback) noexcept;
-            bool                                                                ResolveAddress(bool domain, const std::string& hostname, int port, ResolveAddressAsyncCallback&& callback) noexcept;
+            bool                                                                ConnectConnection(const AsioContext& context, int channelId, Int64 token, const boost::asio::ip::tcp::endpoint& remoteEP, ConnectConnectionAsyncCallback&& callback) noexcept;
+            bool                                                                ResolveAddress(const AsioContext& context, bool domain, const std::string& hostname, int port, ResolveAddressAsyncCallback&& callback) noexcept;
 
         public:
             virtual bool                                                        Listen() noexcept;
@@ -71,10 +176,13 @@ namespace uds {
             std::shared_ptr<uds::threading::Hosting>                            hosting_;
             std::shared_ptr<uds::configuration::AppConfiguration>               configuration_;
             std::shared_ptr<boost::asio::io_context>                            context_;
-            std::shared_ptr<boost::asio::ip::tcp::acceptor>                     acceptor_;
+            std::shared_ptr<uds::cryptography::EncryptorKey>                    encryptor_;
+            AcceptorList                                                        acceptors_;
             std::shared_ptr<boost::asio::ip::tcp::resolver>                     resolver_;
             TimeoutTable                                                        timeouts_;
             ConnectionTable                                                     connections_;
+            TransmissionPoolTable                                               pools_;
+            MultiplexerSlotTable                                                multiplexers_;
         };
     }
 }
\ No newline at end of file
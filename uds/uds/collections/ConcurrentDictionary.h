@@ -0,0 +1,132 @@
+#pragma once
+
+#include <uds/collections/Dictionary.h>
+
+namespace uds {
+    namespace collections {
+        /* Hash table split into independently locked shards, a key only ever contends with keys of the same shard. */
+        template<typename TKey, typename TValue, int Concurrency = 64>
+        class ConcurrentDictionary final {
+            static_assert(Concurrency > 0 && (Concurrency & (Concurrency - 1)) == 0, "Concurrency must be a power of two.");
+
+        public:
+            typedef std::unordered_map<TKey, TValue>                        Table;
+            typedef std::mutex                                              Mutex;
+            typedef std::lock_guard<Mutex>                                  MutexScope;
+
+        public:
+            inline ConcurrentDictionary() noexcept
+                : count_(0) {
+
+            }
+
+        public:
+            inline bool                                                     TryAdd(const TKey& key, const TValue& value) noexcept {
+                Shard& shard = GetShard(key);
+                {
+                    MutexScope scope_(shard.syncobj_);
+                    if (!Dictionary::TryAdd(shard.table_, key, value)) {
+                        return false;
+                    }
+                }
+
+                count_++;
+                return true;
+            }
+            inline bool                                                     TryRemove(const TKey& key) noexcept {
+                Shard& shard = GetShard(key);
+                {
+                    MutexScope scope_(shard.syncobj_);
+                    if (!Dictionary::TryRemove(shard.table_, key)) {
+                        return false;
+                    }
+                }
+
+                count_--;
+                return true;
+            }
+            inline bool                                                     TryRemove(const TKey& key, TValue& value) noexcept {
+                Shard& shard = GetShard(key);
+                {
+                    MutexScope scope_(shard.syncobj_);
+                    if (!Dictionary::TryRemove(shard.table_, key, value)) {
+                        return false;
+                    }
+                }
+
+                count_--;
+                return true;
+            }
+            /* Removes the key only while the predicate accepts the value it maps to, under the lock of its shard. */
+            template<typename Predicate>
+            inline bool                                                     TryRemoveIf(const TKey& key, Predicate&& predicate) noexcept {
+                Shard& shard = GetShard(key);
+                {
+                    MutexScope scope_(shard.syncobj_);
+                    typename Table::iterator tail = shard.table_.find(key);
+                    if (tail == shard.table_.end() || !predicate(tail->second)) {
+                        return false;
+                    }
+                    shard.table_.erase(tail);
+                }
+
+                count_--;
+                return true;
+            }
+            inline bool                                                     TryGetValue(const TKey& key, TValue& value) noexcept {
+                Shard& shard = GetShard(key);
+                MutexScope scope_(shard.syncobj_);
+                return Dictionary::TryGetValue(shard.table_, key, value);
+            }
+            inline bool                                                     ContainsKey(const TKey& key) noexcept {
+                Shard& shard = GetShard(key);
+                MutexScope scope_(shard.syncobj_);
+                return Dictionary::ContainsKey(shard.table_, key);
+            }
+            inline int                                                      Count() noexcept {
+                return count_;
+            }
+
+        public:
+            /* Detaches every shard and hands the values to the handler outside of the shard locks. */
+            template<typename CloseHandler>
+            inline int                                                      ReleaseAllPairs(CloseHandler&& handler) noexcept {
+                int length = 0;
+                for (int i = 0; i < Concurrency; i++) {
+                    Table table;
+                    {
+                        Shard& shard = shards_[i];
+                        MutexScope scope_(shard.syncobj_);
+                        table.swap(shard.table_);
+                    }
+
+                    int count = Dictionary::ReleaseAllPairs(table, handler);
+                    count_ -= count;
+                    length += count;
+                }
+                return length;
+            }
+            inline int                                                      ReleaseAllPairs() noexcept {
+                return ReleaseAllPairs(
+                    [](TValue& p) noexcept {
+                        p->Close();
+                    });
+            }
+
+        private:
+            struct Shard {
+                alignas(64) Mutex                                           syncobj_;
+                Table                                                       table_;
+            };
+            inline Shard&                                                   GetShard(const TKey& key) noexcept {
+                /* Fibonacci hashing spreads sequential ids and aligned pointers evenly across the shards. */
+                uint64_t hash = (uint64_t)std::hash<TKey>()(key) * 11400714819323198485llu;
+                return shards_[(hash >> 32) & (Concurrency - 1)];
+            }
+
+        private:
+            Shard                                                           shards_[Concurrency];
+            std::atomic<int>                                                count_;
+        };
+    }
+}
@@ -19,7 +19,18 @@ namespace uds {
             if (evp_passwd.empty()) {
                 return false;
             }
-            return uds::cryptography::Encryptor::Support(evp_method);
+
+            if (!uds::cryptography::Encryptor::Support(evp_method)) {
+                return false;
+            }
+
+            /* AEAD frames carry their tag, a message of alignment bytes must still be sealed as one frame within a relay buffer. */
+            if (uds::cryptography::EncryptorKey::IsAEADCipher(EVP_get_cipherbyname(evp_method.data()))) {
+                if (config.Alignment > uds::threading::Hosting::BufferSize - uds::cryptography::Encryptor::EENCRYPTOR_TAG) {
+                    return false;
+                }
+            }
+            return true;
         }
 
         static bool AppConfiguration_VeritySslConfiguration(const AppConfiguration& config, bool hostVerify) noexcept {
@@ -32,6 +43,8 @@ namespace uds {
             const std::string& ssl_certificate_chain_file = config.Protocols.Ssl.CertificateChainFile;
             const std::string& ssl_certificate_key_password = config.Protocols.Ssl.CertificateKeyPassword;
             const std::string& ssl_ciphersuites = config.Protocols.Ssl.Ciphersuites;
+            const int& ssl_min_version = config.Protocols.Ssl.MinVersion;
+            const int& ssl_max_version = config.Protocols.Ssl.MaxVersion;
 
             if (hostVerify && ssl_host.empty()) {
                 return false;
@@ -41,11 +54,29 @@ namespace uds {
                 return false;
             }
 
+            if (ssl_min_version < 1 || ssl_max_version < 1 || ssl_min_version > ssl_max_version) {
+                return false;
+            }
+
+            /* Loading the shared context is the verification, handshakes then start from the preloaded one. */
             if (config.Mode == LoopbackMode::LoopbackMode_Server) {
-                if (!uds::ssl::SSL::VerifySslCertificate(
+                std::shared_ptr<boost::asio::ssl::context> ssl_context = uds::ssl::SSL::GetServerSslContext(uds::ssl::SSL::SSL_METHOD::tls,
                     ssl_certificate_file,
                     ssl_certificate_key_file,
-                    ssl_certificate_chain_file)) {
+                    ssl_certificate_chain_file,
+                    ssl_certificate_key_password,
+                    ssl_ciphersuites,
+                    config.Protocols.Ssl.GetOptions());
+                if (!ssl_context) {
+                    return false;
+                }
+            }
+            else {
+                std::shared_ptr<boost::asio::ssl::context> ssl_context = uds::ssl::SSL::GetClientSslContext(uds::ssl::SSL::SSL_METHOD::tls,
+                    ssl_verify_peer,
+                    ssl_ciphersuites,
+                    config.Protocols.Ssl.GetOptions());
+                if (!ssl_context) {
                     return false;
                 }
             }
@@ -96,6 +127,11 @@ namespace uds {
             std::string& ssl_certificate_chain_file = configuration->Protocols.Ssl.CertificateChainFile;
             std::string& ssl_certificate_key_password = configuration->Protocols.Ssl.CertificateKeyPassword;
             std::string& ssl_ciphersuites = configuration->Protocols.Ssl.Ciphersuites;
+            bool& ssl_kernel_tls = configuration->Protocols.Ssl.KernelTls;
+            int& ssl_min_version = configuration->Protocols.Ssl.MinVersion;
+            int& ssl_max_version = configuration->Protocols.Ssl.MaxVersion;
+            std::string& ssl_groups = configuration->Protocols.Ssl.Groups;
+            std::string& ssl_ciphers = configuration->Protocols.Ssl.Ciphers;
 
             if (configuration->Protocol == ProtocolType::ProtocolType_SSL ||
                 configuration->Protocol == ProtocolType::ProtocolType_WebSocket_SSL) {
@@ -106,6 +142,11 @@ namespace uds {
                 ssl_certificate_chain_file = section["protocol.ssl.certificate-chain-file"];
                 ssl_certificate_key_password = section["protocol.ssl.certificate-key-password"];
                 ssl_ciphersuites = section["protocol.ssl.ciphersuites"];
+                ssl_kernel_tls = section.GetValue<bool>("protocol.ssl.ktls");
+                ssl_min_version = uds::ssl::SSL::GetSslVersion(section["protocol.ssl.min-version"], TLS1_3_VERSION);
+                ssl_max_version = uds::ssl::SSL::GetSslVersion(section["protocol.ssl.max-version"], TLS1_3_VERSION);
+                ssl_groups = section["protocol.ssl.groups"];
+                ssl_ciphers = section["protocol.ssl.ciphers"];
             }
             else {
                 ssl_verify_peer = section.GetValue<bool>("protocol.tls.verify-peer");
@@ -115,12 +156,25 @@ namespace uds {
                 ssl_certificate_chain_file = section["protocol.tls.certificate-chain-file"];
                 ssl_certificate_key_password = section["protocol.tls.certificate-key-password"];
                 ssl_ciphersuites = section["protocol.tls.ciphersuites"];
+                ssl_kernel_tls = section.GetValue<bool>("protocol.tls.ktls");
+                ssl_min_version = uds::ssl::SSL::GetSslVersion(section["protocol.tls.min-version"], TLS1_3_VERSION);
+                ssl_max_version = uds::ssl::SSL::GetSslVersion(section["protocol.tls.max-version"], TLS1_3_VERSION);
+                ssl_groups = section["protocol.tls.groups"];
+                ssl_ciphers = section["protocol.tls.ciphers"];
             }
 
             if (ssl_ciphersuites.empty()) {
                 ssl_ciphersuites = uds::ssl::SSL::GetSslCiphersuites();
             }
 
+            if (ssl_groups.empty()) {
+                ssl_groups = uds::ssl::SSL::GetSslGroups();
+            }
+
+            if (ssl_ciphers.empty()) {
+                ssl_ciphers = uds::ssl::SSL::GetSslCiphers();
+            }
+
             return ssl_host.size() > 0;
         }
 
@@ -177,6 +231,9 @@ namespace uds {
                 configuration->Mode = LoopbackMode::LoopbackMode_Client;
                 configuration->Alignment = section.GetValue<int>("alignment");
                 configuration->Backlog = section.GetValue<int>("backlog");
+                configuration->Concurrent = section.GetValue<int>("concurrent");
+                configuration->ReusePort = section.GetValue<bool>("reuse-port");
+                configuration->Coalescing = section.GetValue<int>("coalescing");
                 configuration->IP = section["ip"];
                 configuration->Port = section.GetValue<int>("port");
                 configuration->Inbound.IP = section["inbound-ip"];
@@ -185,8 +242,17 @@ namespace uds {
                 configuration->Outbound.Port = section.GetValue<int>("outbound-port");
                 configuration->FastOpen = section.GetValue<bool>("fast-open");
                 configuration->Turbo = section.GetValue<bool>("turbo");
+                configuration->Splice = section.GetValue<bool>("splice");
                 configuration->Connect.Timeout = section.GetValue<int>("connect.timeout");
                 configuration->Handshake.Timeout = section.GetValue<int>("handshake.timeout");
+                configuration->Handshake.Parallel = section.GetValue<bool>("handshake.parallel");
+                configuration->Pipeline.Segments = section.GetValue<int>("pipeline.segments");
+                configuration->Pipeline.Window = section.GetValue<int>("pipeline.window");
+                configuration->Crypto.Concurrent = section.GetValue<int>("crypto.concurrent");
+                configuration->Pool.Size = section.GetValue<int>("pool.size");
+                configuration->Pool.Idle = section.GetValue<int>("pool.idle");
+                configuration->Multiplex.Enabled = section.GetValue<bool>("multiplex.enabled");
+                configuration->Multiplex.Window = section.GetValue<int>("multiplex.window");
                 configuration->Inbound.Domain = false;
                 configuration->Outbound.Domain = false;
                 configuration->KeepAlived = section.GetValue<bool>("keep-alived");
@@ -239,6 +305,48 @@ namespace uds {
                     alignment = (UINT8_MAX << 1);
                 }
 
+                int& poolSize = configuration->Pool.Size;
+                if (poolSize < 0) {
+                    poolSize = 0;
+                }
+
+                /* A pooled leg is already waiting on the server's connect timeout, it must be used or dropped well before that. */
+                int& poolIdle = configuration->Pool.Idle;
+                if (poolIdle < 1 || poolIdle >= connectTimeout) {
+                    poolIdle = std::max<int>(1, connectTimeout >> 1);
+                }
+
+                int& concurrent = configuration->Concurrent;
+                if (concurrent < 1) {
+                    concurrent = 1; /* One worker unless more are asked for, as before the worker pool existed. */
+                }
+
+                int& coalescing = configuration->Coalescing;
+                if (coalescing < 1) {
+                    coalescing = uds::threading::Hosting::BufferSize;
+                }
+
+                int& pipelineSegments = configuration->Pipeline.Segments;
+                if (pipelineSegments < 1) {
+                    pipelineSegments = 1;
+                }
+
+                int& pipelineWindow = configuration->Pipeline.Window;
+                if (pipelineWindow < 1) {
+                    pipelineWindow = pipelineSegments * alignment;
+                }
+
+                /* Every stream starts with a 64 KiB credit, the window only ever grows it. */
+                int& multiplexWindow = configuration->Multiplex.Window;
+                if (multiplexWindow < 65536) {
+                    multiplexWindow = std::max<int>(65536, pipelineWindow);
+                }
+
+                int& cryptoConcurrent = configuration->Crypto.Concurrent;
+                if (cryptoConcurrent < 0) {
+                    cryptoConcurrent = 0;
+                }
+
                 int& port = configuration->Port;
                 if (port < IPEndPoint::MinPort || port > IPEndPoint::MaxPort) {
                     port = IPEndPoint::MinPort;
@@ -418,6 +526,18 @@ namespace uds {
                 return true;
             }
 
+            if (config.Concurrent < 1) {
+                return true;
+            }
+
+            if (config.Coalescing < 1) {
+                return true;
+            }
+
+            if (config.Pipeline.Segments < 1 || config.Pipeline.Window < 1) {
+                return true;
+            }
+
             if (config.Alignment < (UINT8_MAX << 1) || config.Alignment > uds::threading::Hosting::BufferSize) {
                 return true;
             }
@@ -24,15 +24,35 @@ namespace uds {
             }                                           Inbound, Outbound;
             int                                         Alignment = 0;
             int                                         Backlog = 511;
+            int                                         Concurrent = 1;
+            bool                                        ReusePort = false;
+            int                                         Coalescing = 0;
             bool                                        FastOpen = false;
             bool                                        Turbo = false;
+            bool                                        Splice = false;
             bool                                        KeepAlived = false;
             struct {
                 int                                     Timeout = 10;
             }                                           Connect;
             struct {
                 int                                     Timeout = 5;
+                bool                                    Parallel = false;
             }                                           Handshake;
+            struct {
+                int                                     Segments = 1;
+                int                                     Window = 0;
+            }                                           Pipeline;
+            struct {
+                int                                     Concurrent = 0;
+            }                                           Crypto;
+            struct {
+                int                                     Size = 0;
+                int                                     Idle = 0;
+            }                                           Pool;
+            struct {
+                bool                                    Enabled = false;
+                int                                     Window = 0;
+            }                                           Multiplex;
             enum ProtocolType {
                 ProtocolType_None,
                 ProtocolType_TCP = LoopbackMode_None,
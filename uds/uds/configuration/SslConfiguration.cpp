@@ -10,6 +10,21 @@ namespace uds {
             CertificateChainFile.clear();
             CertificateKeyPassword.clear();
             Ciphersuites.clear();
+            KernelTls = false;
+            MinVersion = TLS1_3_VERSION;
+            MaxVersion = TLS1_3_VERSION;
+            Groups.clear();
+            Ciphers.clear();
+        }
+
+        uds::ssl::SslOptions SslConfiguration::GetOptions() const noexcept {
+            uds::ssl::SslOptions options;
+            options.KernelTls = KernelTls;
+            options.MinVersion = MinVersion;
+            options.MaxVersion = MaxVersion;
+            options.Groups = Groups;
+            options.Ciphers = Ciphers;
+            return options;
         }
     }
 }
\ No newline at end of file
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <uds/stdafx.h>
+#include <uds/ssl/SSL.h>
 
 namespace uds {
     namespace configuration {
@@ -13,9 +13,15 @@ namespace uds {
             std::string                         CertificateChainFile;
             std::string                         CertificateKeyPassword;
             std::string                         Ciphersuites;
+            bool                                KernelTls = false;
+            int                                 MinVersion = TLS1_3_VERSION;
+            int                                 MaxVersion = TLS1_3_VERSION;
+            std::string                         Groups;
+            std::string                         Ciphers;
 
         public:
             void                                ReleaseAllPairs() noexcept;
+            uds::ssl::SslOptions                GetOptions() const noexcept;
         };
     }
 }
\ No newline at end of file
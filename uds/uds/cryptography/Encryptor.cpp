@@ -1,67 +1,190 @@
 #include <uds/cryptography/Encryptor.h>
+#include <openssl/kdf.h>
 
 namespace uds {
     namespace cryptography {
         Encryptor::Encryptor(const std::string& method, const std::string& password) noexcept
+            : Encryptor(make_shared_object<EncryptorKey>(method, password)) {
+
+        }
+
+        Encryptor::Encryptor(const std::shared_ptr<EncryptorKey>& key) noexcept
             : _cipher(NULL)
-            , _method(method)
-            , _password(password) {
-            initKey(method, password);
-            initCipher(_encryptCTX, 1, 1);
-            initCipher(_decryptCTX, 0, 1);
+            , _aead(false)
+            , _rekey(false)
+            , _encryptSalted(false)
+            , _decryptSalted(false)
+            , _material(key) {
+            memset(_encryptNonce, 0, sizeof(_encryptNonce));
+            memset(_decryptNonce, 0, sizeof(_decryptNonce));
+            initCipher();
         }
 
-        void Encryptor::initKey(const std::string& method, const std::string password) {
-            _cipher = EVP_get_cipherbyname(method.data());
-            if (NULL == _cipher) {
-                throw std::runtime_error("Such encryption cipher methods are not supported");
+        void Encryptor::initCipher() {
+            if (NULL == _material) {
+                throw std::runtime_error("Encryptor key material is not available");
             }
 
-            _iv = make_shared_alloc<Byte>(EVP_CIPHER_iv_length(_cipher)); /* RAND_bytes(iv.get(), ivLen); */
-            if (NULL == _iv) {
-                throw std::runtime_error("Unable to alloc iv block memory.");
+            _cipher = _material->GetCipher();
+            _aead = _material->IsAEAD();
+            _rekey = !_aead && EVP_CIPHER_iv_length(_cipher) < 1;
+
+            /* Copies of the prepared templates, neither a cipher lookup nor a key derivation happens per connection. */
+            _encryptCTX = _material->NewContext(1);
+            _decryptCTX = _material->NewContext(0);
+            if (NULL == _encryptCTX || NULL == _decryptCTX) {
+                throw std::runtime_error("There was a problem initializing the cipher that caused an exception to be thrown");
             }
+        }
 
-            _key = make_shared_alloc<Byte>(EVP_CIPHER_key_length(_cipher));
-            if (NULL == _key) {
-                throw std::runtime_error("Unable to alloc key block memory.");
+        int Encryptor::GetSaltSize() noexcept {
+            return std::max<int>(EVP_CIPHER_key_length(_cipher), 16);
+        }
+
+        bool Encryptor::SetSalt(const Byte* salt, int salt_size, int enc) noexcept {
+            if (!_aead || NULL == salt || salt_size < GetSaltSize()) {
+                return false;
             }
 
-            if (EVP_BytesToKey(_cipher, EVP_md5(), NULL, (Byte*)password.data(), (int)password.length(), 1, _key.get(), _iv.get()) < 1) {
-                throw std::runtime_error("Bytes to key calculations cannot be performed using cipher with md5(md) key password iv key etc");
+            /* HKDF-SHA256(master key, salt) gives each session and direction its own subkey, so the counter nonce never repeats under a key. */
+            Byte subkey[EVP_MAX_KEY_LENGTH];
+            size_t subkey_size = EVP_CIPHER_key_length(_cipher);
+            static const char info[] = "uds-subkey";
+
+            EVP_PKEY_CTX* pctx = EVP_PKEY_CTX_new_id(EVP_PKEY_HKDF, NULL);
+            bool success = NULL != pctx &&
+                EVP_PKEY_derive_init(pctx) > 0 &&
+                EVP_PKEY_CTX_set_hkdf_md(pctx, EVP_sha256()) > 0 &&
+                EVP_PKEY_CTX_set1_hkdf_salt(pctx, (Byte*)salt, salt_size) > 0 &&
+                EVP_PKEY_CTX_set1_hkdf_key(pctx, _material->GetKey(), (int)subkey_size) > 0 &&
+                EVP_PKEY_CTX_add1_hkdf_info(pctx, (Byte*)info, (int)(sizeof(info) - 1)) > 0 &&
+                EVP_PKEY_derive(pctx, subkey, &subkey_size) > 0;
+            if (NULL != pctx) {
+                EVP_PKEY_CTX_free(pctx);
+            }
+
+            if (success) {
+                std::shared_ptr<EVP_CIPHER_CTX>& context = enc ? _encryptCTX : _decryptCTX;
+                success = EVP_CipherInit_ex(context.get(), NULL, NULL, subkey, NULL, enc) > 0;
+            }
+
+            OPENSSL_cleanse(subkey, sizeof(subkey));
+            if (success) {
+                if (enc) {
+                    memset(_encryptNonce, 0, sizeof(_encryptNonce));
+                    _encryptSalted = true;
+                }
+                else {
+                    memset(_decryptNonce, 0, sizeof(_decryptNonce));
+                    _decryptSalted = true;
+                }
+            }
+            return success;
+        }
+
+        void Encryptor::NextNonce(Byte* nonce) noexcept {
+            /* Little-endian packet counter. */
+            for (int i = 0; i < EENCRYPTOR_NONCE; i++) {
+                if (++nonce[i]) {
+                    break;
+                }
             }
         }
 
-        bool Encryptor::initCipher(std::shared_ptr<EVP_CIPHER_CTX>& context, int enc, int raise) {
-            bool exception = false;
-            do {
-                if (NULL == context.get()) {
-                    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
-                    context = std::shared_ptr<EVP_CIPHER_CTX>(ctx,
-                        [](EVP_CIPHER_CTX* context) noexcept {
-                            EVP_CIPHER_CTX_cleanup(context);
-                            EVP_CIPHER_CTX_free(context);
-                        });
-                    EVP_CIPHER_CTX_init(context.get());
-                    if ((exception = EVP_CipherInit_ex(context.get(), _cipher, NULL, NULL, NULL, enc) < 1)) {
-                        break;
-                    }
-                    if ((exception = EVP_CIPHER_CTX_set_key_length(context.get(), EVP_CIPHER_key_length(_cipher)) < 1)) {
-                        break;
-                    }
-                    if ((exception = EVP_CIPHER_CTX_set_padding(context.get(), 1) < 1)) {
-                        break;
-                    }
+        int Encryptor::decrypt(Byte* data, int datalen, Byte* out) noexcept {
+            std::shared_ptr<EVP_CIPHER_CTX>& context = _decryptCTX;
+            if (!_aead) {
+                if (EVP_CipherInit_ex(context.get(), NULL, NULL, GetRekey(), _material->GetIV(), 0) < 1) { // RESET-IV
+                    return -1;
                 }
-            } while (0);
-            if (exception) {
-                if (raise) {
-                    context = NULL;
-                    throw std::runtime_error("There was a problem initializing the cipher that caused an exception to be thrown");
+
+                int feedbacklen = datalen + EVP_CIPHER_block_size(_cipher);
+                if (EVP_CipherUpdate(context.get(), out, &feedbacklen, data, datalen) < 1) {
+                    return -1;
                 }
-                return false;
+                return feedbacklen;
+            }
+
+            /* ciphertext || tag */
+            int textlen = datalen - EENCRYPTOR_TAG;
+            if (!_decryptSalted || textlen < 1) {
+                return -1;
+            }
+
+            if (EVP_CipherInit_ex(context.get(), NULL, NULL, NULL, _decryptNonce, 0) < 1) {
+                return -1;
+            }
+
+            if (EVP_CIPHER_CTX_ctrl(context.get(), EVP_CTRL_AEAD_SET_TAG, EENCRYPTOR_TAG, data + textlen) < 1) {
+                return -1;
+            }
+
+            int feedbacklen = textlen;
+            if (EVP_CipherUpdate(context.get(), out, &feedbacklen, data, textlen) < 1) {
+                return -1;
+            }
+
+            int finallen = 0;
+            if (EVP_CipherFinal_ex(context.get(), out + feedbacklen, &finallen) < 1) { // VERIFY-TAG
+                return -1;
+            }
+
+            NextNonce(_decryptNonce);
+            return feedbacklen + finallen;
+        }
+
+        int Encryptor::encrypt(Byte* data, int datalen, Byte* out, Byte* tag) noexcept {
+            std::shared_ptr<EVP_CIPHER_CTX>& context = _encryptCTX;
+            if (!_aead) {
+                if (EVP_CipherInit_ex(context.get(), NULL, NULL, GetRekey(), _material->GetIV(), 1) < 1) { // RESET-IV
+                    return -1;
+                }
+
+                int feedbacklen = datalen + EVP_CIPHER_block_size(_cipher);
+                if (EVP_CipherUpdate(context.get(), out, &feedbacklen, data, datalen) < 1) {
+                    return -1;
+                }
+                return feedbacklen;
+            }
+
+            if (!_encryptSalted) {
+                return -1;
+            }
+
+            if (EVP_CipherInit_ex(context.get(), NULL, NULL, NULL, _encryptNonce, 1) < 1) {
+                return -1;
+            }
+
+            int feedbacklen = datalen;
+            if (EVP_CipherUpdate(context.get(), out, &feedbacklen, data, datalen) < 1) {
+                return -1;
+            }
+
+            int finallen = 0;
+            if (EVP_CipherFinal_ex(context.get(), out + feedbacklen, &finallen) < 1) {
+                return -1;
+            }
+
+            if (EVP_CIPHER_CTX_ctrl(context.get(), EVP_CTRL_AEAD_GET_TAG, EENCRYPTOR_TAG, tag) < 1) {
+                return -1;
+            }
+
+            NextNonce(_encryptNonce);
+            return feedbacklen + finallen;
+        }
+
+        int Encryptor::EncryptInPlace(Byte* data, int datalen, Byte* tag) noexcept {
+            if (NULL == data || datalen < 1 || (_aead && NULL == tag) || !SupportInPlace()) {
+                return -1;
+            }
+            return encrypt(data, datalen, data, tag);
+        }
+
+        int Encryptor::DecryptInPlace(Byte* data, int datalen) noexcept {
+            if (NULL == data || datalen < 1 || !SupportInPlace()) {
+                return -1;
             }
-            return true;
+            return decrypt(data, datalen, data);
         }
 
         std::shared_ptr<Byte> Encryptor::Decrypt(Byte* data, int datalen, int& outlen) noexcept {
@@ -75,21 +198,15 @@ namespace uds {
                 return NULL;
             }
 
-            std::shared_ptr<EVP_CIPHER_CTX>& context = _decryptCTX;
-            if (EVP_CipherInit_ex(context.get(), _cipher, NULL, _key.get(), _iv.get(), 0) < 1) { // INIT-CTX
-                return NULL;
-            }
-
             // DECR-DATA
-            int feedbacklen = datalen + EVP_CIPHER_block_size(_cipher);
-            std::shared_ptr<Byte> cipherText = make_shared_alloc<Byte>(feedbacklen);
+            std::shared_ptr<Byte> cipherText = make_shared_alloc<Byte>(datalen + EVP_CIPHER_block_size(_cipher));
             if (NULL == cipherText) {
                 return NULL;
             }
 
-            if (EVP_CipherUpdate(context.get(),
-                cipherText.get(), &feedbacklen, data, datalen) < 1) {
-                feedbacklen = ~0;
+            int feedbacklen = decrypt(data, datalen, cipherText.get());
+            if (feedbacklen < 0) {
+                outlen = ~0;
                 return NULL;
             }
 
@@ -108,25 +225,20 @@ namespace uds {
                 return NULL;
             }
 
-            std::shared_ptr<EVP_CIPHER_CTX>& context = _encryptCTX;
-            if (EVP_CipherInit_ex(context.get(), _cipher, NULL, _key.get(), _iv.get(), 1) < 1) { // INIT-CTX
-                return NULL;
-            }
-
             // ENCR-DATA
-            int feedbacklen = datalen + EVP_CIPHER_block_size(_cipher);
-            std::shared_ptr<Byte> cipherText = make_shared_alloc<Byte>(feedbacklen);
+            std::shared_ptr<Byte> cipherText = make_shared_alloc<Byte>(datalen + EVP_CIPHER_block_size(_cipher) + GetTagSize());
             if (NULL == cipherText) {
                 return NULL;
             }
 
-            if (EVP_CipherUpdate(context.get(),
-                cipherText.get(), &feedbacklen, data, datalen) < 1) {
+            /* ciphertext || tag */
+            int feedbacklen = encrypt(data, datalen, cipherText.get(), cipherText.get() + datalen);
+            if (feedbacklen < 0) {
                 outlen = ~0;
                 return NULL;
             }
 
-            outlen = feedbacklen;
+            outlen = feedbacklen + GetTagSize();
             return cipherText;
         }
 
@@ -142,7 +254,24 @@ namespace uds {
             if (method.empty()) {
                 return false;
             }
-            return NULL != EVP_get_cipherbyname(method.data());
+
+            const EVP_CIPHER* cipher = EVP_get_cipherbyname(method.data());
+            if (NULL == cipher) {
+                return false;
+            }
+            elif((EVP_CIPHER_flags(cipher) & EVP_CIPH_FLAG_AEAD_CIPHER) && !EncryptorKey::IsAEADCipher(cipher)) {
+                return false;
+            }
+
+            /* A name can resolve to a cipher that no loaded provider implements, or one that refuses a plain context such as key wrap. */
+            EVP_CIPHER_CTX* context = EVP_CIPHER_CTX_new();
+            if (NULL == context) {
+                return false;
+            }
+
+            bool available = EVP_CipherInit_ex(context, cipher, NULL, NULL, NULL, 1) > 0;
+            EVP_CIPHER_CTX_free(context);
+            return available;
         }
     }
 }
\ No newline at end of file
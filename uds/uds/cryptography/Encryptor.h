@@ -1,12 +1,13 @@
 #pragma once
 
-#include <uds/stdafx.h>
+#include <uds/cryptography/EncryptorKey.h>
 
 namespace uds {
     namespace cryptography {
         class Encryptor final {
         public:
             Encryptor(const std::string& method, const std::string& password) noexcept;
+            Encryptor(const std::shared_ptr<EncryptorKey>& key) noexcept;
 
         public:
             static void                                         Initialize() noexcept;
@@ -16,16 +17,48 @@ namespace uds {
             std::shared_ptr<Byte>                               Encrypt(Byte* data, int datalen, int& outlen) noexcept;
             std::shared_ptr<Byte>                               Decrypt(Byte* data, int datalen, int& outlen) noexcept;
 
+        public:
+            /* In-place variants, only for ciphers whose ciphertext is as long as the plaintext. */
+            inline bool                                         SupportInPlace() noexcept {
+                return EVP_CIPHER_block_size(_cipher) == 1;
+            }
+            int                                                 EncryptInPlace(Byte* data, int datalen, Byte* tag) noexcept;
+            int                                                 DecryptInPlace(Byte* data, int datalen) noexcept;
+
+        public:
+            /* AEAD methods seal every packet with a tag under a per-session subkey, see SetSalt. */
+            inline bool                                         IsAEAD() noexcept {
+                return _aead;
+            }
+            inline int                                          GetTagSize() noexcept {
+                return _aead ? EENCRYPTOR_TAG : 0;
+            }
+            int                                                 GetSaltSize() noexcept;
+            bool                                                SetSalt(const Byte* salt, int salt_size, int enc) noexcept;
+
         private:
-            bool                                                initCipher(std::shared_ptr<EVP_CIPHER_CTX>& context, int enc, int raise);
-            void                                                initKey(const std::string& method, const std::string password);
+            static void                                         NextNonce(Byte* nonce) noexcept;
+            /* Legacy packets each start over from the derived key and iv, resetting the iv restarts every mode except IV-less stream ciphers such as rc4, those are keyed again. */
+            inline const Byte*                                  GetRekey() noexcept {
+                return _rekey ? _material->GetKey() : NULL;
+            }
+            int                                                 encrypt(Byte* data, int datalen, Byte* out, Byte* tag) noexcept;
+            int                                                 decrypt(Byte* data, int datalen, Byte* out) noexcept;
+            void                                                initCipher();
+
+        public:
+            static const int                                    EENCRYPTOR_TAG = 16;
 
         private:
+            static const int                                    EENCRYPTOR_NONCE = 12;
             const EVP_CIPHER*                                   _cipher;
-            std::shared_ptr<Byte>                               _key; // _cipher->key_len
-            std::shared_ptr<Byte>                               _iv;
-            std::string                                         _method;
-            std::string                                         _password;
+            bool                                                _aead;
+            bool                                                _rekey;
+            bool                                                _encryptSalted;
+            bool                                                _decryptSalted;
+            Byte                                                _encryptNonce[EENCRYPTOR_NONCE];
+            Byte                                                _decryptNonce[EENCRYPTOR_NONCE];
+            std::shared_ptr<EncryptorKey>                       _material;
             std::shared_ptr<EVP_CIPHER_CTX>                     _encryptCTX;
             std::shared_ptr<EVP_CIPHER_CTX>                     _decryptCTX;
         };
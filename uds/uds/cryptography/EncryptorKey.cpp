@@ -0,0 +1,102 @@
+#include <uds/cryptography/EncryptorKey.h>
+
+namespace uds {
+    namespace cryptography {
+        EncryptorKey::EncryptorKey(const std::string& method, const std::string& password)
+            : _cipher(NULL)
+            , _aead(false)
+            , _method(method) {
+            initKey(method, password);
+            initCipher(_encryptCTX, 1);
+            initCipher(_decryptCTX, 0);
+        }
+
+        void EncryptorKey::initKey(const std::string& method, const std::string& password) {
+            _cipher = EVP_get_cipherbyname(method.data());
+            if (NULL == _cipher) {
+                throw std::runtime_error("Such encryption cipher methods are not supported");
+            }
+
+            _aead = IsAEADCipher(_cipher);
+            _iv = make_shared_alloc<Byte>(std::max<int>(EVP_CIPHER_iv_length(_cipher), 1)); /* RAND_bytes(iv.get(), ivLen); ECB and RC4 take no iv at all. */
+            if (NULL == _iv) {
+                throw std::runtime_error("Unable to alloc iv block memory.");
+            }
+
+            _key = make_shared_alloc<Byte>(EVP_CIPHER_key_length(_cipher));
+            if (NULL == _key) {
+                throw std::runtime_error("Unable to alloc key block memory.");
+            }
+
+            if (EVP_BytesToKey(_cipher, EVP_md5(), NULL, (Byte*)password.data(), (int)password.length(), 1, _key.get(), _iv.get()) < 1) {
+                throw std::runtime_error("Bytes to key calculations cannot be performed using cipher with md5(md) key password iv key etc");
+            }
+        }
+
+        std::shared_ptr<EVP_CIPHER_CTX> EncryptorKey::NewContext() noexcept {
+            EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+            if (NULL == ctx) {
+                return NULL;
+            }
+
+            return std::shared_ptr<EVP_CIPHER_CTX>(ctx,
+                [](EVP_CIPHER_CTX* context) noexcept {
+                    EVP_CIPHER_CTX_cleanup(context);
+                    EVP_CIPHER_CTX_free(context);
+                });
+        }
+
+        bool EncryptorKey::initCipher(std::shared_ptr<EVP_CIPHER_CTX>& context, int enc) {
+            bool exception = false;
+            do {
+                context = NewContext();
+                if ((exception = NULL == context)) {
+                    break;
+                }
+                if ((exception = EVP_CipherInit_ex(context.get(), _cipher, NULL, NULL, NULL, enc) < 1)) {
+                    break;
+                }
+                if ((exception = EVP_CIPHER_CTX_set_key_length(context.get(), EVP_CIPHER_key_length(_cipher)) < 1)) {
+                    break;
+                }
+                if ((exception = EVP_CIPHER_CTX_set_padding(context.get(), 1) < 1)) {
+                    break;
+                }
+
+                /* The key schedule runs once here and is cloned with the template. AEAD contexts are keyed per session by Encryptor::SetSalt. */
+                if (!_aead) {
+                    if ((exception = EVP_CipherInit_ex(context.get(), NULL, NULL, _key.get(), _iv.get(), enc) < 1)) {
+                        break;
+                    }
+                }
+            } while (0);
+            if (exception) {
+                context = NULL;
+                throw std::runtime_error("There was a problem initializing the cipher that caused an exception to be thrown");
+            }
+            return true;
+        }
+
+        std::shared_ptr<EVP_CIPHER_CTX> EncryptorKey::NewContext(int enc) const noexcept {
+            const std::shared_ptr<EVP_CIPHER_CTX>& prototype = enc ? _encryptCTX : _decryptCTX;
+            if (NULL == prototype) {
+                return NULL;
+            }
+
+            std::shared_ptr<EVP_CIPHER_CTX> context = NewContext();
+            if (NULL == context || EVP_CIPHER_CTX_copy(context.get(), prototype.get()) < 1) {
+                return NULL;
+            }
+            return context;
+        }
+
+        bool EncryptorKey::IsAEADCipher(const EVP_CIPHER* cipher) noexcept {
+            if (NULL == cipher || !(EVP_CIPHER_flags(cipher) & EVP_CIPH_FLAG_AEAD_CIPHER)) {
+                return false;
+            }
+
+            /* Only the AEAD modes that take a 12-byte nonce and a detached 16-byte tag without declaring lengths up front. */
+            return EVP_CIPHER_mode(cipher) == EVP_CIPH_GCM_MODE || EVP_CIPHER_nid(cipher) == NID_chacha20_poly1305;
+        }
+    }
+}
\ No newline at end of file
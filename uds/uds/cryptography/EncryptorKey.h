@@ -0,0 +1,49 @@
+#pragma once
+
+#include <uds/stdafx.h>
+
+namespace uds {
+    namespace cryptography {
+        /* Key material of one method and password plus a prepared context per direction, built once and then only read, so every Encryptor of a configuration shares it. */
+        class EncryptorKey final {
+        public:
+            EncryptorKey(const std::string& method, const std::string& password);
+
+        public:
+            inline const EVP_CIPHER*                            GetCipher() const noexcept {
+                return _cipher;
+            }
+            inline const std::string&                           GetMethod() const noexcept {
+                return _method;
+            }
+            inline const Byte*                                  GetKey() const noexcept {
+                return _key.get();
+            }
+            inline const Byte*                                  GetIV() const noexcept {
+                return _iv.get();
+            }
+            inline bool                                         IsAEAD() const noexcept {
+                return _aead;
+            }
+            /* Clones the template of a direction, the clone carries the cipher and, for legacy methods, the finished key schedule. */
+            std::shared_ptr<EVP_CIPHER_CTX>                     NewContext(int enc) const noexcept;
+
+        public:
+            static bool                                         IsAEADCipher(const EVP_CIPHER* cipher) noexcept;
+
+        private:
+            static std::shared_ptr<EVP_CIPHER_CTX>              NewContext() noexcept;
+            bool                                                initCipher(std::shared_ptr<EVP_CIPHER_CTX>& context, int enc);
+            void                                                initKey(const std::string& method, const std::string& password);
+
+        private:
+            const EVP_CIPHER*                                   _cipher;
+            bool                                                _aead;
+            std::shared_ptr<Byte>                               _key; // _cipher->key_len
+            std::shared_ptr<Byte>                               _iv;
+            std::string                                         _method;
+            std::shared_ptr<EVP_CIPHER_CTX>                     _encryptCTX;
+            std::shared_ptr<EVP_CIPHER_CTX>                     _decryptCTX;
+        };
+    }
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include <uds/io/File.h>
 #include <uds/io/MemoryStream.h>
 #include <uds/text/Encoding.h>
+#include <sys/stat.h>
 
 namespace uds {
     namespace io {
@@ -21,6 +22,18 @@ namespace uds {
             return length;
         }
 
+        Int64 File::GetLastWriteTime(const char* path) noexcept {
+            if (NULL == path) {
+                return ~0;
+            }
+
+            struct stat st;
+            if (stat(path, &st) != 0) {
+                return ~0;
+            }
+            return (Int64)st.st_mtime;
+        }
+
         bool File::Exists(const char* path) noexcept {
             if (NULL == path) {
                 return false;
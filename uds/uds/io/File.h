@@ -15,6 +15,7 @@ namespace uds {
             static bool                         CanAccess(const char* path, FileAccess access_) noexcept;
             static int                          GetLength(const char* path) noexcept;
             static bool                         Exists(const char* path) noexcept;
+            static Int64                        GetLastWriteTime(const char* path) noexcept;
             static int                          GetEncoding(const void* p, int length, int& offset) noexcept;
             static std::shared_ptr<Byte>        ReadAllBytes(const char* path, int& length) noexcept;
             static bool                         WriteAllBytes(const char* path, const void* data, int length) noexcept;
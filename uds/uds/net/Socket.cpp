@@ -276,6 +276,18 @@ namespace uds {
             return ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, (char*)&flag, sizeof(flag)) == 0;
         }
 
+        bool Socket::ReuseSocketPort(int fd, bool reuse) noexcept {
+            if (fd == -1) {
+                return false;
+            }
+#ifdef SO_REUSEPORT
+            int flag = reuse ? 1 : 0;
+            return ::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, (char*)&flag, sizeof(flag)) == 0;
+#else
+            return !reuse;
+#endif
+        }
+
         void Socket::AdjustDefaultSocketOptional(int sockfd, bool in4) noexcept {
             if (sockfd != -1) {
                 uint8_t tos = 0x68;
@@ -405,9 +417,33 @@ namespace uds {
                 return false;
             }
 
+            return AcceptLoopbackAsync(hosting, NULL, acceptor, forward0f(callback));
+        }
+
+        bool Socket::AcceptLoopbackAsync(
+            const Hosting&                                          hosting,
+            const boost::asio::ip::tcp::acceptor&                   acceptor,
+            const BOOST_ASIO_MOVE_ARG(AcceptLoopbackCallback)       callback) noexcept {
+            return AcceptLoopbackAsync(hosting, NULL, acceptor, forward0f(callback));
+        }
+
+        bool Socket::AcceptLoopbackAsync(
+            const Hosting&                                          hosting,
+            const AsioContext&                                      context,
+            const AsioTcpAcceptor&                                  acceptor,
+            const BOOST_ASIO_MOVE_ARG(AcceptLoopbackCallback)       callback) noexcept {
+            if (!acceptor || !acceptor->is_open()) {
+                return false;
+            }
+
+            if (!hosting || !callback) {
+                Closesocket(acceptor);
+                return false;
+            }
+
             const AsioTcpAcceptor acceptor_ = acceptor;
             const AcceptLoopbackCallback callback_ = BOOST_ASIO_MOVE_CAST(AcceptLoopbackCallback)(constantof(callback));
-            if (Socket::AcceptLoopbackAsync(hosting, *acceptor,
+            if (Socket::AcceptLoopbackAsync(hosting, context, *acceptor,
                 [acceptor_, callback_](const AsioContext& context, const AsioTcpSocket& socket) noexcept {
                     return callback_(context, socket);
                 })) {
@@ -421,6 +457,7 @@ namespace uds {
 
         bool Socket::AcceptLoopbackAsync(
             const Hosting&                                          hosting,
+            const AsioContext&                                      context,
             const boost::asio::ip::tcp::acceptor&                   acceptor,
             const BOOST_ASIO_MOVE_ARG(AcceptLoopbackCallback)       callback) noexcept {
             if (!acceptor.is_open()) {
@@ -432,7 +469,8 @@ namespace uds {
                 return false;
             }
 
-            const AsioContext context_ = hosting->GetContext();
+            /* Accepted sockets are pinned to the given context (a sharded acceptor), otherwise they are spread over the worker contexts. */
+            const AsioContext context_ = context ? context : hosting->GetAnyContext();
             if (!context_) {
                 Closesocket(acceptor);
                 return false;
@@ -440,11 +478,12 @@ namespace uds {
 
             boost::asio::ip::tcp::acceptor* const acceptor_ = addressof(acceptor);
             const Hosting                         hosting_ = hosting;
+            const AsioContext                     affinity_ = context;
             const AcceptLoopbackCallback          accept_ = BOOST_ASIO_MOVE_CAST(AcceptLoopbackCallback)(constantof(callback));
             const AsioTcpSocket                   socket_ = make_shared_object<boost::asio::ip::tcp::socket>(*context_);
 
             acceptor_->async_accept(*socket_,
-                [hosting_, context_, acceptor_, accept_, socket_](const boost::system::error_code& ec) noexcept {
+                [hosting_, affinity_, context_, acceptor_, accept_, socket_](const boost::system::error_code& ec) noexcept {
                     if (ec == boost::system::errc::operation_canceled) {
                         Closesocket(*acceptor_);
                         return;
@@ -463,14 +502,20 @@ namespace uds {
                         Socket::SetDontFragment(handle_, false);
                         Socket::ReuseSocketAddress(handle_, true);
 
-                        /* Accept Socket?? */
-                        success = accept_(context_, socket_);
+                        /* Accept Socket?? The accept handler runs on the worker context that owns the socket. */
+                        boost::asio::dispatch(*context_,
+                            [context_, accept_, socket_]() noexcept {
+                                if (!accept_(context_, socket_)) {
+                                    Closesocket(socket_);
+                                }
+                            });
+                        success = true;
                     } while (0);
                     if (!success) {
                         Closesocket(socket_);
                     }
 
-                    success = AcceptLoopbackAsync(hosting_, *acceptor_, forward0f(accept_));
+                    success = AcceptLoopbackAsync(hosting_, affinity_, *acceptor_, forward0f(accept_));
                     if (!success) {
                         Closesocket(*acceptor_);
                     }
@@ -484,7 +529,8 @@ namespace uds {
             int                                                     listenPort,
             int                                                     backlog,
             bool                                                    fastOpen,
-            bool                                                    noDelay) noexcept {
+            bool                                                    noDelay,
+            bool                                                    reusePort) noexcept {
             typedef uds::net::IPEndPoint IPEndPoint;
 
             if (listenPort < IPEndPoint::MinPort || listenPort > IPEndPoint::MaxPort) {
@@ -519,6 +565,9 @@ namespace uds {
             uds::net::Socket::SetSignalPipeline(handle, false);
             uds::net::Socket::SetDontFragment(handle, false);
             uds::net::Socket::ReuseSocketAddress(handle, listenPort);
+            if (reusePort && !uds::net::Socket::ReuseSocketPort(handle, true)) {
+                return false;
+            }
 
             acceptor_.set_option(boost::asio::ip::tcp::acceptor::reuse_address(listenPort), ec);
             if (ec) {
@@ -549,6 +598,66 @@ namespace uds {
             return true;
         }
 
+        bool Socket::OpenAcceptor(
+            const Hosting&                                          hosting,
+            const AsioContext&                                      context,
+            AsioTcpAcceptorList&                                    acceptors,
+            const boost::asio::ip::address&                         listenIP,
+            int                                                     listenPort,
+            int                                                     backlog,
+            bool                                                    fastOpen,
+            bool                                                    noDelay,
+            bool                                                    reusePort,
+            const BOOST_ASIO_MOVE_ARG(AcceptLoopbackCallback)       callback) noexcept {
+            typedef uds::net::IPEndPoint IPEndPoint;
+
+            if (!hosting || !context || !callback) {
+                return false;
+            }
+
+            if (listenPort < IPEndPoint::MinPort || listenPort > IPEndPoint::MaxPort) {
+                listenPort = IPEndPoint::MinPort;
+            }
+
+            /* In the sharded listener mode every worker context owns an acceptor bound with SO_REUSEPORT, the kernel spreads the incoming connections over them. */
+            uds::threading::Hosting::ContextList contexts;
+            reusePort = reusePort && hosting->GetConcurrency() > 1;
+            if (reusePort) {
+                contexts = hosting->GetContexts();
+            }
+            else {
+                contexts.push_back(context);
+            }
+
+            for (const AsioContext& context_ : contexts) {
+                AsioTcpAcceptor acceptor = make_shared_object<boost::asio::ip::tcp::acceptor>(*context_);
+                if (!acceptor) {
+                    return false;
+                }
+
+                if (!OpenAcceptor(*acceptor, listenIP, listenPort, backlog, fastOpen, noDelay, reusePort)) {
+                    Closesocket(*acceptor);
+                    return false;
+                }
+
+                /* All shards must listen on the same port, including the one picked by the system. */
+                int localPort = LocalPort(*acceptor);
+                if (acceptors.size() && localPort != listenPort) {
+                    Closesocket(*acceptor);
+                    return false;
+                }
+
+                listenPort = localPort;
+                acceptors.push_back(acceptor);
+
+                AcceptLoopbackCallback accept = callback;
+                if (!AcceptLoopbackAsync(hosting, reusePort ? context_ : NULL, acceptor, std::move(accept))) {
+                    return false;
+                }
+            }
+            return acceptors.size() > 0;
+        }
+
         bool Socket::OpenSocket(
             const boost::asio::ip::udp::socket&                     socket,
             const boost::asio::ip::address&                         listenIP,
@@ -10,6 +10,7 @@ namespace uds {
             typedef std::shared_ptr<boost::asio::ip::tcp::socket>                       AsioTcpSocket;
             typedef std::shared_ptr<boost::asio::io_context>                            AsioContext;
             typedef std::shared_ptr<boost::asio::ip::tcp::acceptor>                     AsioTcpAcceptor;
+            typedef std::vector<AsioTcpAcceptor>                                        AsioTcpAcceptorList;
             typedef std::shared_ptr<boost::asio::ip::udp::socket>                       AsioUdpSocket;
             typedef std::function<bool(const AsioContext&, const AsioTcpSocket&)>       AcceptLoopbackCallback;
             typedef std::function<bool(const std::shared_ptr<Byte>&, int)>              ReceiveFromLoopbackCallback;
@@ -36,13 +37,35 @@ namespace uds {
                 const Hosting&                                                          hosting,
                 const boost::asio::ip::tcp::acceptor&                                   acceptor,
                 const BOOST_ASIO_MOVE_ARG(AcceptLoopbackCallback)                       callback) noexcept;
+            static bool                                                                 AcceptLoopbackAsync(
+                const Hosting&                                                          hosting,
+                const AsioContext&                                                      context,
+                const AsioTcpAcceptor&                                                  acceptor,
+                const BOOST_ASIO_MOVE_ARG(AcceptLoopbackCallback)                       callback) noexcept;
+            static bool                                                                 AcceptLoopbackAsync(
+                const Hosting&                                                          hosting,
+                const AsioContext&                                                      context,
+                const boost::asio::ip::tcp::acceptor&                                   acceptor,
+                const BOOST_ASIO_MOVE_ARG(AcceptLoopbackCallback)                       callback) noexcept;
             static bool                                                                 OpenAcceptor(
                 const boost::asio::ip::tcp::acceptor&                                   acceptor,
                 const boost::asio::ip::address&                                         listenIP,
                 int                                                                     listenPort,
                 int                                                                     backlog,
                 bool                                                                    fastOpen,
-                bool                                                                    noDelay) noexcept;
+                bool                                                                    noDelay,
+                bool                                                                    reusePort = false) noexcept;
+            static bool                                                                 OpenAcceptor(
+                const Hosting&                                                          hosting,
+                const AsioContext&                                                      context,
+                AsioTcpAcceptorList&                                                    acceptors,
+                const boost::asio::ip::address&                                         listenIP,
+                int                                                                     listenPort,
+                int                                                                     backlog,
+                bool                                                                    fastOpen,
+                bool                                                                    noDelay,
+                bool                                                                    reusePort,
+                const BOOST_ASIO_MOVE_ARG(AcceptLoopbackCallback)                       callback) noexcept;
             static bool                                                                 OpenSocket(
                 const boost::asio::ip::udp::socket&                                     socket,
                 const boost::asio::ip::address&                                         listenIP,
@@ -88,6 +111,7 @@ namespace uds {
             static bool                                                                 SetSignalPipeline(int fd, bool sigpipe) noexcept;
             static bool                                                                 SetDontFragment(int fd, bool dontFragment) noexcept;
             static bool                                                                 ReuseSocketAddress(int fd, bool reuse) noexcept;
+            static bool                                                                 ReuseSocketPort(int fd, bool reuse) noexcept;
 
         public:
             static int                                                                  GetHandle(const boost::asio::ip::tcp::acceptor& acceptor) noexcept;
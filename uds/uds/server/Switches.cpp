@@ -5,6 +5,7 @@
 #include <uds/net/IPEndPoint.h>
 #include <uds/threading/Timer.h>
 #include <uds/threading/Hosting.h>
+#include <uds/ssl/SSL.h>
 #include <uds/transmission/Transmission.h>
 #include <uds/transmission/EncryptorTransmission.h>
 #include <uds/transmission/SslSocketTransmission.h>
@@ -26,6 +27,17 @@ namespace uds {
             if (hosting) {
                 context_ = hosting->GetContext();
             }
+
+            /* Every transmission of this configuration shares one key derivation and clones its cipher contexts from it. */
+            if (configuration && configuration->Protocol == AppConfiguration::ProtocolType_Encryptor) {
+                encryptor_ = make_shared_object<uds::cryptography::EncryptorKey>(configuration->Protocols.Encryptor.Method, configuration->Protocols.Encryptor.Password);
+            }
+        }
+
+        bool Switches::OpenAcceptor(AcceptorList& acceptors, const uds::net::IPEndPoint& bindEP, const uds::net::Socket::AcceptLoopbackCallback&& loopback) noexcept {
+            boost::asio::ip::address address = IPEndPoint::ToEndPoint<boost::asio::ip::tcp>(bindEP).address();
+            return Socket::OpenAcceptor(hosting_, context_, acceptors, address, bindEP.Port,
+                configuration_->Backlog, configuration_->FastOpen, configuration_->Turbo, configuration_->ReusePort, forward0f(loopback));
         }
 
         bool Switches::Listen() noexcept {
@@ -40,15 +52,34 @@ namespace uds {
             }
 
             std::shared_ptr<Reference> references = GetReference();
-            acceptor_[0] = OpenAcceptor(inboundEP,
+            bool success = OpenAcceptor(acceptors_[0], inboundEP,
                 [references, this](const AsioContext& context, const AsioTcpSocket& socket) noexcept {
+                    if (configuration_->Handshake.Parallel) {
+                        return ProposalAcceptClient(context, socket, true);
+                    }
                     return InboundAcceptClient(context, socket);
                 });
-            acceptor_[1] = OpenAcceptor(outboundEP,
+            success = success && OpenAcceptor(acceptors_[1], outboundEP,
                 [references, this](const AsioContext& context, const AsioTcpSocket& socket) noexcept {
+                    if (configuration_->Handshake.Parallel) {
+                        return ProposalAcceptClient(context, socket, false);
+                    }
                     return OutboundAcceptClient(context, socket);
                 });
-            if (acceptor_[0] && acceptor_[1]) {
+            if (success) {
+                switch (configuration_->Protocol) {
+                case AppConfiguration::ProtocolType_SSL:
+                case AppConfiguration::ProtocolType_TLS:
+                case AppConfiguration::ProtocolType_WebSocket_SSL:
+                case AppConfiguration::ProtocolType_WebSocket_TLS:
+                    success = NextReloadCycle();
+                    break;
+                default:
+                    break;
+                };
+            }
+
+            if (success) {
                 return true;
             }
 
@@ -56,32 +87,53 @@ namespace uds {
             return false;
         }
 
+        bool Switches::NextReloadCycle() noexcept {
+            if (disposed_) {
+                return false;
+            }
+
+            /* Certificate files are checked from the main context once a second, handshakes only take the current context. */
+            const std::shared_ptr<Reference> references = GetReference();
+            reload_ = uds::threading::SetTimeout(context_,
+                [references, this](void* key) noexcept {
+                    reload_.reset();
+                    uds::ssl::SSL::ReloadSslContexts();
+                    NextReloadCycle();
+                }, 1000);
+            return NULL != reload_;
+        }
+
         void Switches::Dispose() noexcept {
             if (!disposed_.exchange(true)) {
                 /* Close the TCP socket acceptor function to prevent the system from continuously processing connections. */
                 CloseAcceptor();
 
                 /* Clear all timeouts. */
-                Dictionary::ReleaseAllPairs(timeouts_,
+                uds::threading::ClearTimeout(reload_);
+                timeouts_.ReleaseAllPairs(
                     [](TimeoutPtr& timeout) noexcept {
                         uds::threading::Hosting::Cancel(timeout);
                     });
 
-                /* Close all connection-channels. */
-                Dictionary::ReleaseAllPairs(channels_);
+                /* Close all connection-channels, including the legs still waiting for their pair. */
+                channels_.ReleaseAllPairs();
+                proposals_.ReleaseAllPairs();
 
-                /* Close all connection. */
-                Dictionary::ReleaseAllPairs(connections_);
+                /* Close all connection, and the leg pairs the multiplexed ones ran over. */
+                connections_.ReleaseAllPairs();
+                multiplexers_.ReleaseAllPairs();
             }
         }
 
         void Switches::CloseAcceptor() noexcept {
-            for (int i = 0, len = arraysizeof(acceptor_); i < len; i++) {
-                std::shared_ptr<boost::asio::ip::tcp::acceptor>& acceptor = acceptor_[i];
-                if (acceptor) {
-                    Socket::Closesocket(*acceptor);
+            for (int i = 0, len = arraysizeof(acceptors_); i < len; i++) {
+                AcceptorList& acceptors = acceptors_[i];
+                for (AcceptorPtr& acceptor : acceptors) {
+                    if (acceptor) {
+                        Socket::Closesocket(*acceptor);
+                    }
                 }
-                acceptor.reset();
+                acceptors.clear();
             }
         }
 
@@ -100,7 +152,7 @@ namespace uds {
                                 }
 
                                 int channelId = channel->channel_;
-                                if (!AddTimeout(network.get(), uds::threading::SetTimeout(hosting_,
+                                if (!AddTimeout(network.get(), uds::threading::SetTimeout(inbound->GetContext(),
                                     [references, this, channel, channelId, network](void* key) noexcept -> void {
                                         ClearTimeout(key);
                                         CloseChannel(channelId);
@@ -135,7 +187,7 @@ namespace uds {
                 [references, this](const ITransmissionPtr& transmission, bool handshaked) noexcept {
                     const ITransmissionPtr outbound = transmission;
                     if (handshaked) {
-                        handshaked = AddTimeout(outbound.get(), uds::threading::SetTimeout(hosting_,
+                        handshaked = AddTimeout(outbound.get(), uds::threading::SetTimeout(outbound->GetContext(),
                             [references, this, outbound](void* key) noexcept -> void {
                                 ClearTimeout(key);
                                 outbound->Close();
@@ -162,13 +214,122 @@ namespace uds {
                 });
         }
 
+        bool Switches::ProposalAcceptClient(const AsioContext& context, const AsioTcpSocket& socket, bool inbound) noexcept {
+            const std::shared_ptr<Reference> references = GetReference();
+            const AsioTcpSocket network = socket;
+            return HandshakeTransmission(context, socket,
+                [references, this, network, inbound](const ITransmissionPtr& transmission, bool handshaked) noexcept {
+                    /* Inbound legs are timed by their socket as the connection-channel expects, outbound legs by themselves. */
+                    const ITransmissionPtr leg = transmission;
+                    void* key = inbound ? (void*)network.get() : (void*)leg.get();
+                    if (handshaked) {
+                        handshaked = AddTimeout(key, uds::threading::SetTimeout(leg->GetContext(),
+                            [references, this, leg](void* key) noexcept -> void {
+                                ClearTimeout(key);
+                                leg->Close();
+                            }, (UInt64)configuration_->Connect.Timeout * 1000));
+                        handshaked = handshaked && Connection::AcceptProposalAsync(leg,
+                            [references, this, leg, network, inbound, key](bool success, Int64 token) noexcept -> void {
+                                if (success) {
+                                    success = PairChannel(token, network, leg, inbound);
+                                }
+
+                                if (!success) {
+                                    ClearTimeout(key);
+                                    leg->Close();
+                                }
+                            });
+                        if (!handshaked) {
+                            ClearTimeout(key);
+                        }
+                    }
+
+                    if (!handshaked) {
+                        if (transmission) {
+                            transmission->Close();
+                        }
+                    }
+                });
+        }
+
+        bool Switches::PairChannel(Int64 token, const AsioTcpSocket& network, const ITransmissionPtr& transmission, bool inbound) noexcept {
+            ConnectionChannelPtr proposal = make_shared_object<ConnectionChannel>();
+            if (!proposal) {
+                return false;
+            }
+
+            void* key = transmission.get();
+            if (inbound) {
+                key = network.get();
+                proposal->inbound_ = transmission;
+                proposal->network_ = network;
+            }
+            else {
+                proposal->outbound_ = transmission;
+            }
+
+            /* Armed before the leg becomes visible in the table, so the pairing leg never races a later re-arm. */
+            const std::shared_ptr<Reference> references = GetReference();
+            if (!AddTimeout(key, uds::threading::SetTimeout(transmission->GetContext(),
+                [references, this, token, proposal](void* key) noexcept -> void {
+                    /* Already paired, the pairing leg took the timeout out and its cancel is still on the way. */
+                    ConnectionChannelPtr pending;
+                    if (!ClearTimeout(key)) {
+                        return;
+                    }
+                    if (proposals_.TryGetValue(token, pending) && pending == proposal) {
+                        proposals_.TryRemove(token);
+                    }
+                    proposal->Close();
+                }, (UInt64)configuration_->Connect.Timeout * 1000))) {
+                return false;
+            }
+
+            /* The first leg of a token waits in the table, the second one takes it out and completes the pair. */
+            ConnectionChannelPtr peer;
+            while (!proposals_.TryAdd(token, proposal)) {
+                if (proposals_.TryRemove(token, peer)) {
+                    break;
+                }
+            }
+
+            if (!peer) {
+                return true;
+            }
+
+            const ITransmissionPtr inbound_leg = inbound ? transmission : peer->inbound_;
+            const ITransmissionPtr outbound_leg = inbound ? peer->outbound_ : transmission;
+            const AsioTcpSocket inbound_network = inbound ? network : peer->network_;
+            if (!inbound_leg || !outbound_leg) {
+                ClearTimeout(inbound ? (void*)peer->network_.get() : (void*)peer->outbound_.get());
+                peer->Close();
+                return false;
+            }
+
+            /* The outbound leg stops waiting here, the inbound one once its connection-channel is accepted. */
+            if (!ClearTimeout(outbound_leg.get())) {
+                ClearTimeout(inbound_network.get());
+                inbound_leg->Close();
+                return false;
+            }
+
+            ConnectionChannelPtr channel = AllocChannel(inbound_network, inbound_leg);
+            if (!channel) {
+                ClearTimeout(inbound_network.get());
+                inbound_leg->Close();
+                outbound_leg->Close();
+                return false;
+            }
+            return AcceptChannel(channel->channel_, outbound_leg);
+        }
+
         Switches::ConnectionChannelPtr Switches::PopChannel(int channel) noexcept {
             if (!channel) {
                 return NULL;
             }
 
             ConnectionChannelPtr connection;
-            if (!Dictionary::TryRemove(channels_, channel, connection)) {
+            if (!channels_.TryRemove(channel, connection)) {
                 return NULL;
             }
             return std::move(connection);
@@ -179,26 +340,25 @@ namespace uds {
                 return NULL;
             }
 
-            for (;;) {
-                int channelId = ++channel_;
-                if (!channelId) {
-                    continue;
-                }
+            ConnectionChannelPtr channel = make_shared_object<ConnectionChannel>();
+            if (!channel) {
+                return NULL;
+            }
 
-                if (Dictionary::ContainsKey(channels_, channelId)) {
-                    continue;
-                }
+            channel->inbound_ = inbound;
+            channel->network_ = network;
 
-                ConnectionChannelPtr channel = make_shared_object<ConnectionChannel>();
-                if (!channel) {
+            /* Ids come from a wrapping counter, a collision is only possible after it wraps around a long-lived channel. */
+            for (;;) {
+                int channelId = ++channel_ & INT32_MAX;
+                if (!channelId) {
                     continue;
                 }
 
                 channel->channel_ = channelId;
-                channel->inbound_ = inbound;
-                channel->network_ = network;
-                channels_[channelId] = channel;
-                return std::move(channel);
+                if (channels_.TryAdd(channelId, channel)) {
+                    return std::move(channel);
+                }
             }
         }
 
@@ -219,19 +379,95 @@ namespace uds {
 
             /* CHANNEL: S <-> C: RX(inbound) <-> TX(outbound). */
             ConnectionPtr connection = CreateConnection(channel, inbound, outbound);
-            if (connection) {
+            if (!connection) {
+                return false;
+            }
+
+            /* The id is claimed before anything can dispose the connection, a taken id fails this tunnel and leaves its owner alone. */
+            if (!connections_.TryAdd(channel, connection)) {
+                return false;
+            }
+
+            std::shared_ptr<Reference> references = GetReference();
+            connection->DisposedEvent = [references, this](Connection* connection) noexcept {
+                ReleaseConnection(connection);
+            };
+            if (connection->Listen(NULL)) {
+                return true;
+            }
+
+            connection->Close();
+            return false;
+        }
+
+        bool Switches::AcceptMultiplexer(int channel, const ITransmissionPtr& inbound, const ITransmissionPtr& outbound) noexcept {
+            if (!inbound || !outbound || !channel) {
+                return false;
+            }
+
+            /* The leg pair of a channel stays up and carries every stream the client opens over it. */
+            MultiplexerPtr multiplexer = NewReference<Multiplexer>(configuration_, channel, inbound, outbound);
+            if (!multiplexer) {
+                return false;
+            }
+
+            if (!multiplexers_.TryAdd(channel, multiplexer)) {
+                return false;
+            }
+
+            std::shared_ptr<Reference> references = GetReference();
+            multiplexer->OpenEvent = [references, this](Multiplexer*, const ITransmissionPtr& stream) noexcept {
+                return AcceptStream(stream);
+            };
+            multiplexer->DisposedEvent = [references, this](Multiplexer* multiplexer) noexcept {
+                multiplexers_.TryRemoveIf(multiplexer->Id,
+                    [multiplexer](const MultiplexerPtr& p) noexcept {
+                        return p.get() == multiplexer;
+                    });
+            };
+            if (multiplexer->Listen()) {
+                return true;
+            }
+
+            multiplexer->Close();
+            return false;
+        }
+
+        bool Switches::ReleaseConnection(Connection* connection) noexcept {
+            /* Only the entry that still maps to this connection goes, its id may have been claimed by another one since. */
+            return connections_.TryRemoveIf(connection->Id,
+                [connection](const ConnectionPtr& p) noexcept {
+                    return p.get() == connection;
+                });
+        }
+
+        bool Switches::AcceptStream(const ITransmissionPtr& stream) noexcept {
+            /* Stream ids are only unique within their multiplexer, the connection claims an id of this side by adding itself. */
+            for (;;) {
+                int channelId = ++channel_ & INT32_MAX;
+                if (!channelId) {
+                    continue;
+                }
+
+                ConnectionPtr connection = CreateConnection(channelId, stream, stream);
+                if (!connection) {
+                    return false;
+                }
+                elif(!connections_.TryAdd(channelId, connection)) {
+                    continue;
+                }
+
                 std::shared_ptr<Reference> references = GetReference();
                 connection->DisposedEvent = [references, this](Connection* connection) noexcept {
-                    Dictionary::TryRemove(connections_, connection->Id);
+                    ReleaseConnection(connection);
                 };
                 if (connection->Listen(NULL)) {
-                    if (Dictionary::TryAdd(connections_, channel, connection)) {
-                        return true;
-                    }
+                    return true;
                 }
+
                 connection->Close();
+                return false;
             }
-            return false;
         }
 
         bool Switches::AcceptChannel(int channel, const ITransmissionPtr& outbound) noexcept {
@@ -243,16 +479,45 @@ namespace uds {
             if (!link) {
                 return false;
             }
-            
-            bool success = ClearTimeout(link->network_.get());
-            if (success) {
-                success = Accept(channel, link->inbound_, outbound);
+
+            /* The connection-channel is owned by the worker context of its inbound transmission. */
+            const AsioContext context = link->inbound_->GetContext();
+            if (!context) {
+                link->Close();
+                return false;
             }
 
-            if (!success) {
+            const AsioContext outbound_context = outbound->GetContext();
+            if (!outbound_context) {
                 link->Close();
+                return false;
             }
-            return success;
+
+            /* The outbound leg is moved by the thread that owns it, when the stream allows, otherwise the connection marshals across contexts. */
+            const std::shared_ptr<Reference> references = GetReference();
+            const ITransmissionPtr soutbound = outbound;
+            boost::asio::dispatch(*outbound_context,
+                [references, this, link, channel, soutbound, context]() noexcept {
+                    soutbound->Relocate(context);
+                    boost::asio::dispatch(*context,
+                        [references, this, link, channel, soutbound]() noexcept {
+                            bool success = ClearTimeout(link->network_.get());
+                            if (success) {
+                                if (configuration_->Multiplex.Enabled) {
+                                    success = AcceptMultiplexer(channel, link->inbound_, soutbound);
+                                }
+                                else {
+                                    success = Accept(channel, link->inbound_, soutbound);
+                                }
+                            }
+
+                            if (!success) {
+                                link->Close();
+                                soutbound->Close();
+                            }
+                        });
+                });
+            return true;
         }
 
         bool Switches::HandshakeTransmission(const ITransmissionPtr& transmission, HandshakeAsyncCallback&& callback) noexcept {
@@ -264,7 +529,7 @@ namespace uds {
             const std::shared_ptr<uds::transmission::ITransmission> network = transmission;
             const HandshakeAsyncCallback scallback = callback;
 
-            if (!AddTimeout(network.get(), uds::threading::SetTimeout(hosting_,
+            if (!AddTimeout(network.get(), uds::threading::SetTimeout(network->GetContext(),
                 [reference, this, network, scallback](void* key) noexcept {
                     ClearTimeout(key);
                     network->Close();
@@ -310,12 +575,12 @@ namespace uds {
                     configuration_->Protocols.Ssl.CertificateChainFile,
                     configuration_->Protocols.Ssl.CertificateKeyPassword,
                     configuration_->Protocols.Ssl.Ciphersuites,
+                    configuration_->Protocols.Ssl.GetOptions(),
                     configuration_->Alignment);
             }
             elif(configuration_->Protocol == AppConfiguration::ProtocolType_Encryptor) {
                 transmission = NewReference2<uds::transmission::ITransmission, uds::transmission::EncryptorTransmission>(hosting_, context, socket,
-                    configuration_->Protocols.Encryptor.Method,
-                    configuration_->Protocols.Encryptor.Password,
+                    encryptor_,
                     configuration_->Alignment);
             }
             elif(configuration_->Protocol == AppConfiguration::ProtocolType_WebSocket) {
@@ -334,11 +599,17 @@ namespace uds {
                     configuration_->Protocols.Ssl.CertificateChainFile,
                     configuration_->Protocols.Ssl.CertificateKeyPassword,
                     configuration_->Protocols.Ssl.Ciphersuites,
+                    configuration_->Protocols.Ssl.GetOptions(),
                     configuration_->Alignment);
             }
             else {
                 transmission = NewReference2<uds::transmission::ITransmission, uds::transmission::Transmission>(hosting_, context, socket, configuration_->Alignment);
             }
+
+            std::shared_ptr<uds::transmission::Transmission> transmission_ = AsReference<uds::transmission::Transmission>(transmission);
+            if (transmission_) {
+                transmission_->SetCoalescing(configuration_->Coalescing);
+            }
             return transmission->Constructor(transmission);
         }
 
@@ -358,7 +629,7 @@ namespace uds {
                 ClearTimeout(key);
             }
 
-            bool success = Dictionary::TryAdd(timeouts_, key, timeout);
+            bool success = timeouts_.TryAdd(key, timeout);
             if (!success) {
                 uds::threading::ClearTimeout(timeout);
             }
@@ -371,30 +642,10 @@ namespace uds {
             }
 
             TimeoutPtr timeout;
-            Dictionary::TryRemove(timeouts_, key, timeout);
+            timeouts_.TryRemove(key, timeout);
             return uds::threading::ClearTimeout(timeout);
         }
 
-        std::shared_ptr<boost::asio::ip::tcp::acceptor> Switches::OpenAcceptor(const uds::net::IPEndPoint& bindEP, const uds::net::Socket::AcceptLoopbackCallback&& loopback) noexcept {
-            int listenPort = bindEP.Port;
-            if (listenPort < IPEndPoint::MinPort || listenPort > IPEndPoint::MaxPort) {
-                listenPort = IPEndPoint::MinPort;
-            }
-            
-            boost::asio::ip::address address = IPEndPoint::ToEndPoint<boost::asio::ip::tcp>(bindEP).address();
-            std::shared_ptr<boost::asio::ip::tcp::acceptor> acceptor = NewReference<boost::asio::ip::tcp::acceptor>(*context_);
-            if (!Socket::OpenAcceptor(*acceptor, address, listenPort, configuration_->Backlog, configuration_->FastOpen, configuration_->Turbo)) {
-                Socket::Closesocket(*acceptor);
-                return NULL;
-            }
-
-            if (!Socket::AcceptLoopbackAsync(hosting_, acceptor, BOOST_ASIO_MOVE_CAST(Socket::AcceptLoopbackCallback)(constantof(loopback)))) {
-                Socket::Closesocket(*acceptor);
-                return NULL;
-            }
-            return std::move(acceptor);
-        }
-
         const std::shared_ptr<boost::asio::io_context>& Switches::GetContext() noexcept {
             return context_;
         }
@@ -408,8 +659,9 @@ namespace uds {
         }
 
         const boost::asio::ip::tcp::endpoint Switches::GetLocalEndPoint(bool RX) noexcept {
-            std::shared_ptr<boost::asio::ip::tcp::acceptor> acceptor = acceptor_[RX ? 0 : 1];
-            if (acceptor) {
+            const AcceptorList& acceptors = acceptors_[RX ? 0 : 1];
+            if (acceptors.size()) {
+                const AcceptorPtr& acceptor = acceptors.front();
                 boost::system::error_code ec;
                 return acceptor->local_endpoint(ec);
             }
@@ -423,6 +675,12 @@ namespace uds {
                 inbound->Close();
             }
 
+            ITransmissionPtr outbound = std::move(outbound_);
+            if (outbound) {
+                outbound_.reset();
+                outbound->Close();
+            }
+
             AsioTcpSocket network = std::move(network_);
             if (network) {
                 network_.reset();
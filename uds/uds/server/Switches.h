@@ -1,11 +1,14 @@
 #pragma once
 
 #include <uds/IDisposable.h>
+#include <uds/collections/ConcurrentDictionary.h>
 #include <uds/threading/Hosting.h>
 #include <uds/configuration/AppConfiguration.h>
+#include <uds/cryptography/EncryptorKey.h>
 #include <uds/net/Socket.h>
 #include <uds/net/IPEndPoint.h>
 #include <uds/tunnel/Connection.h>
+#include <uds/tunnel/Multiplexer.h>
 #include <uds/transmission/ITransmission.h>
 
 namespace uds {
@@ -19,23 +22,30 @@ namespace uds {
             using AppConfiguration                                              = uds::configuration::AppConfiguration;
             using HandshakeAsyncCallback                                        = std::function<void(const ITransmissionPtr&, bool)>;
             using TimeoutPtr                                                    = std::shared_ptr<boost::asio::deadline_timer>;
-            using TimeoutTable                                                  = std::unordered_map<void*, TimeoutPtr>;
+            using TimeoutTable                                                  = uds::collections::ConcurrentDictionary<void*, TimeoutPtr>;
             using Connection                                                    = uds::tunnel::Connection;
             using ConnectionPtr                                                 = std::shared_ptr<Connection>;
-            using ConnectionTable                                               = std::unordered_map<int, ConnectionPtr>;
+            using ConnectionTable                                               = uds::collections::ConcurrentDictionary<int, ConnectionPtr>;
+            using Multiplexer                                                   = uds::tunnel::Multiplexer;
+            using MultiplexerPtr                                                = std::shared_ptr<Multiplexer>;
+            using MultiplexerTable                                              = uds::collections::ConcurrentDictionary<int, MultiplexerPtr>;
+            using AcceptorPtr                                                   = std::shared_ptr<boost::asio::ip::tcp::acceptor>;
+            using AcceptorList                                                  = std::vector<AcceptorPtr>;
 
         private:
             class ConnectionChannel final {
             public:
                 int                                                             channel_;
                 ITransmissionPtr                                                inbound_;
+                ITransmissionPtr                                                outbound_;
                 AsioTcpSocket                                                   network_;
 
             public:
                 void                                                            Close() noexcept;
             };
             using ConnectionChannelPtr                                          = std::shared_ptr<ConnectionChannel>;
-            using ConnectionChannelTable                                        = std::unordered_map<int, ConnectionChannelPtr>;
+            using ConnectionChannelTable                                        = uds::collections::ConcurrentDictionary<int, ConnectionChannelPtr>;
+            using ConnectionProposalTable                                       = uds::collections::ConcurrentDictionary<Int64, ConnectionChannelPtr>;
 
         public:
             Switches(const std::shared_ptr<uds::threading::Hosting>& hosting, const std::shared_ptr<uds::configuration::AppConfiguration>& configuration) noexcept;
@@ -51,12 +61,14 @@ namespace uds {
             virtual void                                                        Dispose() noexcept override;
 
         private:
-            std::shared_ptr<boost::asio::ip::tcp::acceptor>                     OpenAcceptor(const uds::net::IPEndPoint& bindEP, const uds::net::Socket::AcceptLoopbackCallback&& loopback) noexcept;
+            bool                                                                OpenAcceptor(AcceptorList& acceptors, const uds::net::IPEndPoint& bindEP, const uds::net::Socket::AcceptLoopbackCallback&& loopback) noexcept;
             void                                                                CloseAcceptor() noexcept;
+            bool                                                                NextReloadCycle() noexcept;
 
         private:
             bool                                                                InboundAcceptClient(const AsioContext& context, const AsioTcpSocket& socket) noexcept;
             bool                                                                OutboundAcceptClient(const AsioContext& context, const AsioTcpSocket& socket) noexcept;
+            bool                                                                ProposalAcceptClient(const AsioContext& context, const AsioTcpSocket& socket, bool inbound) noexcept;
             
         private:
             bool                                                                HandshakeTransmission(const ITransmissionPtr& transmission, HandshakeAsyncCallback&& callback) noexcept;
@@ -71,6 +83,12 @@ namespace uds {
             ConnectionChannelPtr                                                AllocChannel(const AsioTcpSocket& network, const ITransmissionPtr& inbound) noexcept;
             bool                                                                CloseChannel(int channel) noexcept;
             bool                                                                AcceptChannel(int channel, const ITransmissionPtr& outbound) noexcept;
+            bool                                                                PairChannel(Int64 token, const AsioTcpSocket& network, const ITransmissionPtr& transmission, bool inbound) noexcept;
+
+        private:
+            bool                                                                AcceptMultiplexer(int channel, const ITransmissionPtr& inbound, const ITransmissionPtr& outbound) noexcept;
+            bool                                                                AcceptStream(const ITransmissionPtr& stream) noexcept;
+            bool                                                                ReleaseConnection(Connection* connection) noexcept;
 
         protected:
             virtual ITransmissionPtr                                            CreateTransmission(const AsioContext& context, const AsioTcpSocket& socket) noexcept;
@@ -83,10 +101,14 @@ namespace uds {
             std::shared_ptr<uds::threading::Hosting>                            hosting_;
             std::shared_ptr<uds::configuration::AppConfiguration>               configuration_;
             std::shared_ptr<boost::asio::io_context>                            context_;
-            std::shared_ptr<boost::asio::ip::tcp::acceptor>                     acceptor_[2];
+            std::shared_ptr<uds::cryptography::EncryptorKey>                    encryptor_;
+            AcceptorList                                                        acceptors_[2];
             TimeoutTable                                                        timeouts_;
+            TimeoutPtr                                                          reload_;
             ConnectionChannelTable                                              channels_;
+            ConnectionProposalTable                                             proposals_;
             ConnectionTable                                                     connections_;
+            MultiplexerTable                                                    multiplexers_;
         };
     }
 }
\ No newline at end of file
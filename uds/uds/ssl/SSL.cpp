@@ -1,9 +1,373 @@
 #include <uds/ssl/root_certificates.hpp>
 #include <uds/ssl/SSL.h>
 #include <uds/io/File.h>
+#include <openssl/kdf.h>
+
+#ifdef LINUX
+#include <netinet/tcp.h>
+#include <linux/tls.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(i386) || defined(__i386__) || defined(__i386) || defined(_M_IX86)
+#ifdef _WIN32
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#elif defined(__aarch64__) && defined(LINUX)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
 
 namespace uds {
     namespace ssl {
+        /* One generation of a shared context and the resumable sessions its client connections were handed, newest last. */
+        class SslSharedContext final {
+        public:
+            typedef std::mutex                                              Mutex;
+            typedef std::lock_guard<Mutex>                                  MutexScope;
+
+        public:
+            static const int                                                MaxSessions = 64;
+            std::shared_ptr<boost::asio::ssl::context>                      context;
+            Mutex                                                           syncobj;
+            std::deque<SSL_SESSION*>                                        sessions;
+
+        public:
+            ~SslSharedContext() noexcept {
+                for (SSL_SESSION* session : sessions) {
+                    SSL_SESSION_free(session);
+                }
+            }
+        };
+
+        /* The current generation for one set of parameters, the files it was loaded from and how to build the next one. */
+        struct SslSharedContextEntry {
+            typedef std::function<std::shared_ptr<boost::asio::ssl::context>()> CreateSslContext;
+
+            bool                                                            client = false;
+            SslOptions                                                      options;
+            CreateSslContext                                                create;
+            std::shared_ptr<SslSharedContext>                               current;
+            std::vector<std::string>                                        files;
+            std::vector<Int64>                                              last_write_times;   /* Only touched by ReloadSslContexts once the entry exists. */
+        };
+        typedef std::unordered_map<std::string, std::shared_ptr<SslSharedContextEntry> > SslSharedContextTable;
+
+        static SslSharedContext::Mutex                                      SSL_syncobj;
+        static SslSharedContextTable                                        SSL_contexts;
+
+        static int SSL_SharedContextIndex() noexcept {
+            static const int index = SSL_CTX_get_ex_new_index(0, NULL, NULL, NULL, NULL);
+            return index;
+        }
+
+        static int SSL_NewSession(::SSL* ssl, SSL_SESSION* session) noexcept {
+            SslSharedContext* shared = (SslSharedContext*)SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), SSL_SharedContextIndex());
+            if (NULL == shared || !SSL_SESSION_is_resumable(session)) {
+                return 0;
+            }
+
+            /* Returning 1 keeps the reference OpenSSL passed in, the oldest tickets make room for new ones. */
+            SslSharedContext::MutexScope scope(shared->syncobj);
+            shared->sessions.push_back(session);
+            while (shared->sessions.size() > SslSharedContext::MaxSessions) {
+                SSL_SESSION_free(shared->sessions.front());
+                shared->sessions.pop_front();
+            }
+            return 1;
+        }
+
+        /* The traffic secret of the write direction captured from the key log, and how many records the handshake already wrote under it. */
+        struct SslKernelTlsState {
+            Byte                                                            secret[EVP_MAX_MD_SIZE];
+            int                                                             secret_size;
+            int                                                             tickets;
+        };
+
+        static void SSL_FreeKernelTlsState(void* parent, void* ptr, CRYPTO_EX_DATA* ad, int index, long argl, void* argp) noexcept {
+            if (NULL != ptr) {
+                OPENSSL_cleanse(ptr, sizeof(SslKernelTlsState));
+                Mfree(ptr);
+            }
+        }
+
+        static int SSL_KernelTlsIndex() noexcept {
+            static const int index = SSL_get_ex_new_index(0, NULL, NULL, NULL, SSL_FreeKernelTlsState);
+            return index;
+        }
+
+        static SslKernelTlsState* SSL_GetKernelTlsState(const ::SSL* ssl) noexcept {
+            SslKernelTlsState* state = (SslKernelTlsState*)SSL_get_ex_data(ssl, SSL_KernelTlsIndex());
+            if (NULL == state) {
+                state = (SslKernelTlsState*)Malloc(sizeof(SslKernelTlsState));
+                if (NULL == state) {
+                    return NULL;
+                }
+
+                memset(state, 0, sizeof(SslKernelTlsState));
+                if (SSL_set_ex_data((::SSL*)ssl, SSL_KernelTlsIndex(), state) < 1) {
+                    Mfree(state);
+                    return NULL;
+                }
+            }
+            return state;
+        }
+
+        static void SSL_KeylogCallback(const ::SSL* ssl, const char* line) noexcept {
+            /* "<label> <client random> <secret>", only the first application secret of the direction this side writes is kept. */
+            const char* label = SSL_is_server((::SSL*)ssl) ? "SERVER_TRAFFIC_SECRET_0 " : "CLIENT_TRAFFIC_SECRET_0 ";
+            std::size_t label_size = strlen(label);
+            if (NULL == line || strncmp(line, label, label_size) != 0) {
+                return;
+            }
+
+            const char* secret = strchr(line + label_size, ' ');
+            if (NULL == secret) {
+                return;
+            }
+
+            SslKernelTlsState* state = SSL_GetKernelTlsState(ssl);
+            if (NULL == state) {
+                return;
+            }
+
+            long secret_size = 0;
+            Byte* buf = OPENSSL_hexstr2buf(secret + 1, &secret_size);
+            if (NULL != buf) {
+                if (secret_size > 0 && secret_size <= (long)sizeof(state->secret)) {
+                    memcpy(state->secret, buf, secret_size);
+                    state->secret_size = (int)secret_size;
+                }
+                OPENSSL_clear_free(buf, secret_size);
+            }
+        }
+
+        static int SSL_GenerateSessionTicket(::SSL* ssl, void* arg) noexcept {
+            /* Every NewSessionTicket the server sends is one record of the write sequence. */
+            SslKernelTlsState* state = SSL_GetKernelTlsState(ssl);
+            if (NULL != state) {
+                state->tickets++;
+            }
+            return 1;
+        }
+
+        static bool SSL_ExpandLabel(const EVP_MD* md, const Byte* secret, int secret_size, const char* label, Byte* out, int out_size) noexcept {
+            /* HKDF-Expand-Label of RFC 8446 with an empty context. */
+            Byte info[2 + 1 + 255 + 1];
+            int label_size = (int)strlen(label);
+            int info_size = 0;
+            info[info_size++] = (Byte)(out_size >> 8);
+            info[info_size++] = (Byte)(out_size);
+            info[info_size++] = (Byte)(6 + label_size);
+            memcpy(info + info_size, "tls13 ", 6);
+            info_size += 6;
+            memcpy(info + info_size, label, label_size);
+            info_size += label_size;
+            info[info_size++] = 0;
+
+            size_t outlen = out_size;
+            EVP_PKEY_CTX* pctx = EVP_PKEY_CTX_new_id(EVP_PKEY_HKDF, NULL);
+            bool success = NULL != pctx &&
+                EVP_PKEY_derive_init(pctx) > 0 &&
+                EVP_PKEY_CTX_set_hkdf_mode(pctx, EVP_PKEY_HKDEF_MODE_EXPAND_ONLY) > 0 &&
+                EVP_PKEY_CTX_set_hkdf_md(pctx, md) > 0 &&
+                EVP_PKEY_CTX_set1_hkdf_key(pctx, secret, secret_size) > 0 &&
+                EVP_PKEY_CTX_add1_hkdf_info(pctx, info, info_size) > 0 &&
+                EVP_PKEY_derive(pctx, out, &outlen) > 0 && outlen == (size_t)out_size;
+            if (NULL != pctx) {
+                EVP_PKEY_CTX_free(pctx);
+            }
+            return success;
+        }
+
+        static std::string SSL_GetOptionsKey(const SslOptions& options) noexcept {
+            return std::to_string(options.KernelTls) + "\n" + std::to_string(options.MinVersion) + "\n" + std::to_string(options.MaxVersion) + "\n" +
+                options.Groups + "\n" + options.Ciphers;
+        }
+
+        /* AES-GCM only beats ChaCha20-Poly1305 with the AES rounds and the carry-less multiply for GHASH both in hardware. */
+        static bool SSL_HasAesGcmInstructions() noexcept {
+#if defined(__x86_64__) || defined(_M_X64) || defined(i386) || defined(__i386__) || defined(__i386) || defined(_M_IX86)
+#ifdef _WIN32
+            int registers[4] = { 0 };
+            __cpuid(registers, 1);
+            unsigned int ecx = (unsigned int)registers[2];
+#else
+            unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+            if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+                return false;
+            }
+#endif
+            return (ecx & (1u << 25)) && (ecx & (1u << 1)); /* AES-NI, PCLMULQDQ */
+#elif defined(__aarch64__) && defined(LINUX)
+            unsigned long hwcap = getauxval(AT_HWCAP);
+            return (hwcap & HWCAP_AES) && (hwcap & HWCAP_PMULL);
+#elif defined(__aarch64__) || defined(_M_ARM64)
+            return true; /* Every ARM64 target of Apple and Windows ships the ARMv8 crypto extensions. */
+#else
+            return false;
+#endif
+        }
+
+        /* The bundled roots and the system CA paths, parsed once for the process and shared by every client context that verifies its peer. */
+        static X509_STORE* SSL_GetRootCertificateStore() noexcept {
+            static X509_STORE* store = []() noexcept -> X509_STORE* {
+                std::shared_ptr<boost::asio::ssl::context> ssl_context = make_shared_object<boost::asio::ssl::context>(boost::asio::ssl::context::tls_client);
+                if (!ssl_context) {
+                    return NULL;
+                }
+
+                boost::system::error_code ec;
+                load_root_certificates(*ssl_context, ec);
+                ssl_context->set_default_verify_paths(ec);
+
+                X509_STORE* root = SSL_CTX_get_cert_store(ssl_context->native_handle());
+                if (NULL == root || X509_STORE_up_ref(root) < 1) {
+                    return NULL;
+                }
+                return root;
+            }();
+            return store;
+        }
+
+        static void SSL_GetLastWriteTimes(const std::vector<std::string>& files, std::vector<Int64>& last_write_times) noexcept {
+            /* The length as well, a rewrite within the second of the last one still shows. */
+            last_write_times.clear();
+            for (const std::string& file : files) {
+                last_write_times.push_back(uds::io::File::GetLastWriteTime(file.data()));
+                last_write_times.push_back(uds::io::File::GetLength(file.data()));
+            }
+        }
+
+        template<typename CreateSslContext>
+        static std::shared_ptr<SslSharedContext> SSL_NewSharedContext(bool client, const SslOptions& options, CreateSslContext& create) noexcept {
+            std::shared_ptr<SslSharedContext> shared = make_shared_object<SslSharedContext>();
+            if (!shared) {
+                return NULL;
+            }
+
+            shared->context = create();
+            if (!shared->context) {
+                return NULL;
+            }
+
+            /* The version range and groups of the configuration, the server's own cipher order wins unless the client puts ChaCha20 first. */
+            SSL_CTX* ctx = shared->context->native_handle();
+            if (SSL_CTX_set_min_proto_version(ctx, options.MinVersion) < 1 || SSL_CTX_set_max_proto_version(ctx, options.MaxVersion) < 1) {
+                return NULL;
+            }
+
+            if (SSL_CTX_set1_groups_list(ctx, options.Groups.empty() ? SSL::GetSslGroups() : options.Groups.data()) < 1) {
+                return NULL;
+            }
+
+            if (SSL_CTX_set_cipher_list(ctx, options.Ciphers.empty() ? SSL::GetSslCiphers() : options.Ciphers.data()) < 1) {
+                return NULL;
+            }
+
+            if (client) {
+                /* Tickets are single use, each handshake takes one from the cache and the server hands out fresh ones. */
+                SSL_CTX_set_ex_data(ctx, SSL_SharedContextIndex(), shared.get());
+                SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+                SSL_CTX_sess_set_new_cb(ctx, SSL_NewSession);
+            }
+            else {
+                /* A certificate and key that do not load or do not match, say a file caught half written, never replace a working context. */
+                if (SSL_CTX_check_private_key(ctx) < 1) {
+                    return NULL;
+                }
+
+                static const Byte session_id_context[] = { 'u', 'd', 's' };
+                SSL_CTX_set_session_id_context(ctx, session_id_context, sizeof(session_id_context));
+                SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER);
+                SSL_CTX_set_options(ctx, SSL_OP_CIPHER_SERVER_PREFERENCE | SSL_OP_PRIORITIZE_CHACHA);
+            }
+
+            if (options.KernelTls) {
+                SSL_CTX_set_keylog_callback(ctx, SSL_KeylogCallback);
+                if (!client) {
+                    SSL_CTX_set_session_ticket_cb(ctx, SSL_GenerateSessionTicket, NULL, NULL);
+                }
+            }
+            return shared;
+        }
+
+        /* Generations are swapped under the lock and owned by the connections that use them, a reload never pulls a context from under a handshake. */
+        static std::shared_ptr<boost::asio::ssl::context> SSL_GetSharedContext(const std::string& key, bool client, const SslOptions& options, const std::vector<std::string>& files, SslSharedContextEntry::CreateSslContext&& create) noexcept {
+            SslSharedContext::MutexScope scope(SSL_syncobj);
+            std::shared_ptr<SslSharedContextEntry>& entry = SSL_contexts[key];
+            if (!entry) {
+                std::shared_ptr<SslSharedContext> shared = SSL_NewSharedContext(client, options, create);
+                if (!shared) {
+                    SSL_contexts.erase(key);
+                    return NULL;
+                }
+
+                entry = make_shared_object<SslSharedContextEntry>();
+                if (!entry) {
+                    SSL_contexts.erase(key);
+                    return NULL;
+                }
+
+                entry->client = client;
+                entry->options = options;
+                entry->create = std::move(create);
+                entry->current = shared;
+                entry->files = files;
+                SSL_GetLastWriteTimes(files, entry->last_write_times);
+            }
+
+            const std::shared_ptr<SslSharedContext>& shared = entry->current;
+            return std::shared_ptr<boost::asio::ssl::context>(shared, shared->context.get());
+        }
+
+        void SSL::ReloadSslContexts() noexcept {
+            std::vector<std::shared_ptr<SslSharedContextEntry> > entries;
+            {
+                SslSharedContext::MutexScope scope(SSL_syncobj);
+                for (SslSharedContextTable::iterator tail = SSL_contexts.begin(), endl = SSL_contexts.end(); tail != endl; tail++) {
+                    const std::shared_ptr<SslSharedContextEntry>& entry = tail->second;
+                    if (entry && entry->files.size()) {
+                        entries.push_back(entry);
+                    }
+                }
+            }
+
+            /* The files are read and parsed outside the lock, handshakes keep taking the current generation meanwhile. */
+            for (const std::shared_ptr<SslSharedContextEntry>& entry : entries) {
+                std::vector<Int64> last_write_times;
+                SSL_GetLastWriteTimes(entry->files, last_write_times);
+                if (last_write_times == entry->last_write_times) {
+                    continue;
+                }
+
+                /* Files that do not load are tried again once they change again, not on every check. */
+                entry->last_write_times = std::move(last_write_times);
+
+                std::shared_ptr<SslSharedContext> shared = SSL_NewSharedContext(entry->client, entry->options, entry->create);
+                if (!shared) {
+                    continue;
+                }
+
+                std::shared_ptr<SslSharedContext> current;
+                {
+                    SslSharedContext::MutexScope scope(SSL_syncobj);
+                    current = entry->current;
+                }
+
+                /* Tickets issued before the reload stay redeemable. */
+                Byte keys[80];
+                if (SSL_CTX_get_tlsext_ticket_keys(current->context->native_handle(), keys, sizeof(keys)) > 0) {
+                    SSL_CTX_set_tlsext_ticket_keys(shared->context->native_handle(), keys, sizeof(keys));
+                }
+                OPENSSL_cleanse(keys, sizeof(keys));
+
+                SslSharedContext::MutexScope scope(SSL_syncobj);
+                entry->current = std::move(shared);
+            }
+        }
+
         boost::asio::ssl::context::method SSL::SSL_S_METHOD(int method) noexcept {
             switch (method) {
             case SSL_METHOD::tlsv13:
@@ -142,16 +506,19 @@ namespace uds {
             bool verify_peer, 
             const std::string& ciphersuites) noexcept {
             std::shared_ptr<boost::asio::ssl::context> ssl_context = make_shared_object<boost::asio::ssl::context>(
-                uds::ssl::SSL::SSL_C_METHOD(uds::ssl::SSL::SSL_METHOD::tlsv13));
+                uds::ssl::SSL::SSL_C_METHOD(method));
             if (!ssl_context) {
                 return NULL;
             }
 
             // This holds the root certificate used for verification.
-            load_root_certificates(*ssl_context);
-
-            // This holds the root certificate used for verification.
-            ssl_context->set_default_verify_paths();
+            if (verify_peer) {
+                X509_STORE* store = SSL_GetRootCertificateStore();
+                if (NULL == store) {
+                    return NULL;
+                }
+                SSL_CTX_set1_cert_store(ssl_context->native_handle(), store);
+            }
             ssl_context->set_verify_mode(verify_peer ? boost::asio::ssl::verify_peer : boost::asio::ssl::verify_none);
 
             SSL_CTX_set_cipher_list(ssl_context->native_handle(), "DEFAULT");
@@ -168,13 +535,227 @@ namespace uds {
             return ssl_context;
         }
 
+        std::shared_ptr<boost::asio::ssl::context> SSL::GetServerSslContext(
+            int method,
+            const std::string& certificate_file,
+            const std::string& certificate_key_file,
+            const std::string& certificate_chain_file,
+            const std::string& certificate_key_password,
+            const std::string& ciphersuites,
+            const SslOptions& options) noexcept {
+            std::string key = "server\n" + std::to_string(method) + "\n" + certificate_file + "\n" + certificate_key_file + "\n" +
+                certificate_chain_file + "\n" + certificate_key_password + "\n" + ciphersuites + "\n" + SSL_GetOptionsKey(options);
+            std::vector<std::string> files = { certificate_file, certificate_key_file, certificate_chain_file };
+            return SSL_GetSharedContext(key, false, options, files,
+                [method, certificate_file, certificate_key_file, certificate_chain_file, certificate_key_password, ciphersuites]() noexcept {
+                    return CreateServerSslContext(method, certificate_file, certificate_key_file, certificate_chain_file, certificate_key_password, ciphersuites);
+                });
+        }
+
+        std::shared_ptr<boost::asio::ssl::context> SSL::GetClientSslContext(
+            int method,
+            bool verify_peer,
+            const std::string& ciphersuites,
+            const SslOptions& options) noexcept {
+            std::string key = "client\n" + std::to_string(method) + "\n" + std::to_string(verify_peer) + "\n" + ciphersuites + "\n" + SSL_GetOptionsKey(options);
+            return SSL_GetSharedContext(key, true, options, std::vector<std::string>(),
+                [method, verify_peer, ciphersuites]() noexcept {
+                    return CreateClientSslContext(method, verify_peer, ciphersuites);
+                });
+        }
+
+        bool SSL::ResumeSslSession(::SSL* ssl) noexcept {
+            if (NULL == ssl) {
+                return false;
+            }
+
+            SslSharedContext* shared = (SslSharedContext*)SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), SSL_SharedContextIndex());
+            if (NULL == shared) {
+                return false;
+            }
+
+            SSL_SESSION* session = NULL;
+            {
+                SslSharedContext::MutexScope scope(shared->syncobj);
+                while (!shared->sessions.empty()) {
+                    session = shared->sessions.back();
+                    shared->sessions.pop_back();
+                    if (SSL_SESSION_is_resumable(session)) {
+                        break;
+                    }
+
+                    SSL_SESSION_free(session);
+                    session = NULL;
+                }
+            }
+
+            if (NULL == session) {
+                return false;
+            }
+
+            bool success = SSL_set_session(ssl, session) > 0;
+            SSL_SESSION_free(session);
+            return success;
+        }
+
+        static int SSL_KernelTlsWrite(BIO* bio, const char* data, int length) noexcept {
+            /* Anything OpenSSL still writes, a KeyUpdate answer or an alert, would be sealed under keys the kernel no longer uses. */
+            BIO_clear_retry_flags(bio);
+            return -1;
+        }
+
+        static long SSL_KernelTlsCtrl(BIO* bio, int cmd, long num, void* ptr) noexcept {
+            return cmd == BIO_CTRL_FLUSH ? 1 : 0;
+        }
+
+        static int SSL_KernelTlsCreate(BIO* bio) noexcept {
+            BIO_set_init(bio, 1);
+            return 1;
+        }
+
+        /* Write BIO for OpenSSL once the kernel seals the records: a record it still wants to send fails the SSL_read that caused it, and the read path closes the connection. */
+        static BIO* SSL_NewKernelTlsBio() noexcept {
+            static BIO_METHOD* method = NULL;
+            static std::once_flag once;
+            std::call_once(once,
+                []() noexcept {
+                    method = BIO_meth_new(BIO_get_new_index() | BIO_TYPE_SOURCE_SINK, "uds kernel tls");
+                    if (NULL != method) {
+                        BIO_meth_set_write(method, SSL_KernelTlsWrite);
+                        BIO_meth_set_ctrl(method, SSL_KernelTlsCtrl);
+                        BIO_meth_set_create(method, SSL_KernelTlsCreate);
+                    }
+                });
+            if (NULL == method) {
+                return NULL;
+            }
+            return BIO_new(method);
+        }
+
+        bool SSL::EnableKernelTls(::SSL* ssl, int fd) noexcept {
+#ifdef LINUX
+            if (NULL == ssl || fd == -1 || SSL_version(ssl) != TLS1_3_VERSION) {
+                return false;
+            }
+
+            SslKernelTlsState* state = (SslKernelTlsState*)SSL_get_ex_data(ssl, SSL_KernelTlsIndex());
+            const SSL_CIPHER* cipher = SSL_get_current_cipher(ssl);
+            if (NULL == state || state->secret_size < 1 || NULL == cipher) {
+                return false;
+            }
+
+            const EVP_MD* md = SSL_CIPHER_get_handshake_digest(cipher);
+            if (NULL == md) {
+                return false;
+            }
+
+            /* The client has written nothing under the application keys yet, the server only its session tickets. */
+            Byte seq[8];
+            UInt64 records = SSL_is_server(ssl) ? (UInt64)state->tickets : 0;
+            for (int i = arraysizeof(seq) - 1; i >= 0; i--, records >>= 8) {
+                seq[i] = (Byte)records;
+            }
+
+            union {
+                struct tls_crypto_info                          info;
+                struct tls12_crypto_info_aes_gcm_128            aes_gcm_128;
+                struct tls12_crypto_info_aes_gcm_256            aes_gcm_256;
+                struct tls12_crypto_info_chacha20_poly1305      chacha20_poly1305;
+            } crypto;
+            memset(&crypto, 0, sizeof(crypto));
+
+            Byte iv[12];
+            int crypto_size = 0;
+            bool success = SSL_ExpandLabel(md, state->secret, state->secret_size, "iv", iv, sizeof(iv));
+            switch (SSL_CIPHER_get_id(cipher)) {
+            case TLS1_3_CK_AES_128_GCM_SHA256:
+                crypto_size = sizeof(crypto.aes_gcm_128);
+                crypto.info.cipher_type = TLS_CIPHER_AES_GCM_128;
+                success = success && SSL_ExpandLabel(md, state->secret, state->secret_size, "key", crypto.aes_gcm_128.key, sizeof(crypto.aes_gcm_128.key));
+                memcpy(crypto.aes_gcm_128.salt, iv, sizeof(crypto.aes_gcm_128.salt));
+                memcpy(crypto.aes_gcm_128.iv, iv + sizeof(crypto.aes_gcm_128.salt), sizeof(crypto.aes_gcm_128.iv));
+                memcpy(crypto.aes_gcm_128.rec_seq, seq, sizeof(seq));
+                break;
+            case TLS1_3_CK_AES_256_GCM_SHA384:
+                crypto_size = sizeof(crypto.aes_gcm_256);
+                crypto.info.cipher_type = TLS_CIPHER_AES_GCM_256;
+                success = success && SSL_ExpandLabel(md, state->secret, state->secret_size, "key", crypto.aes_gcm_256.key, sizeof(crypto.aes_gcm_256.key));
+                memcpy(crypto.aes_gcm_256.salt, iv, sizeof(crypto.aes_gcm_256.salt));
+                memcpy(crypto.aes_gcm_256.iv, iv + sizeof(crypto.aes_gcm_256.salt), sizeof(crypto.aes_gcm_256.iv));
+                memcpy(crypto.aes_gcm_256.rec_seq, seq, sizeof(seq));
+                break;
+            case TLS1_3_CK_CHACHA20_POLY1305_SHA256:
+                crypto_size = sizeof(crypto.chacha20_poly1305);
+                crypto.info.cipher_type = TLS_CIPHER_CHACHA20_POLY1305;
+                success = success && SSL_ExpandLabel(md, state->secret, state->secret_size, "key", crypto.chacha20_poly1305.key, sizeof(crypto.chacha20_poly1305.key));
+                memcpy(crypto.chacha20_poly1305.iv, iv, sizeof(crypto.chacha20_poly1305.iv));
+                memcpy(crypto.chacha20_poly1305.rec_seq, seq, sizeof(seq));
+                break;
+            default:
+                success = false;
+                break;
+            }
+
+            /* Without the tls module the ULP is refused and nothing about the socket changes. */
+            crypto.info.version = TLS_1_3_VERSION;
+            BIO* bio = success ? SSL_NewKernelTlsBio() : NULL;
+            success = NULL != bio &&
+                setsockopt(fd, SOL_TCP, TCP_ULP, "tls", sizeof("tls")) == 0 &&
+                setsockopt(fd, SOL_TLS, TLS_TX, &crypto, crypto_size) == 0;
+
+            /* The read BIO stays, SSL_set_bio took a reference of its own for each direction. */
+            if (success) {
+                SSL_set0_wbio(ssl, bio);
+            }
+            elif(NULL != bio) {
+                BIO_free(bio);
+            }
+
+            OPENSSL_cleanse(&crypto, sizeof(crypto));
+            OPENSSL_cleanse(iv, sizeof(iv));
+            OPENSSL_cleanse(state->secret, sizeof(state->secret));
+            state->secret_size = 0;
+            return success;
+#else
+            return false;
+#endif
+        }
+
         const char* SSL::GetSslCiphersuites() noexcept {
-#if !(defined(__aarch64__) || defined(_M_ARM64))
-            if (strstr(GetPlatformCode(), "ARM")) {
+            if (!IsAesGcmFaster()) {
                 return "TLS_CHACHA20_POLY1305_SHA256:TLS_AES_128_GCM_SHA256:TLS_AES_256_GCM_SHA384";
             }
-#endif
-            return "TLS_AES_256_GCM_SHA384:TLS_CHACHA20_POLY1305_SHA256:TLS_AES_128_GCM_SHA256";
+            return "TLS_AES_128_GCM_SHA256:TLS_AES_256_GCM_SHA384:TLS_CHACHA20_POLY1305_SHA256";
+        }
+
+        const char* SSL::GetSslCiphers() noexcept {
+            if (!IsAesGcmFaster()) {
+                return "ECDHE+CHACHA20:ECDHE+AES128GCM:ECDHE+AES256GCM";
+            }
+            return "ECDHE+AES128GCM:ECDHE+AES256GCM:ECDHE+CHACHA20";
+        }
+
+        const char* SSL::GetSslGroups() noexcept {
+            return "X25519:P-256:P-384";
+        }
+
+        int SSL::GetSslVersion(const std::string& name, int default_version) noexcept {
+            std::string version = ToLower<std::string>(name);
+            if (version == "tls1.2" || version == "tlsv1.2" || version == "1.2") {
+                return TLS1_2_VERSION;
+            }
+            elif(version == "tls1.3" || version == "tlsv1.3" || version == "1.3") {
+                return TLS1_3_VERSION;
+            }
+            elif(version.empty()) {
+                return default_version;
+            }
+            return 0;
+        }
+
+        bool SSL::IsAesGcmFaster() noexcept {
+            static const bool faster = SSL_HasAesGcmInstructions();
+            return faster;
         }
     }
 }
\ No newline at end of file
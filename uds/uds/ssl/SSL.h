@@ -4,6 +4,15 @@
 
 namespace uds {
     namespace ssl {
+        /* Settings a shared context is built with beyond its certificates and cipher suites. */
+        struct SslOptions {
+            bool                                                            KernelTls = false;      /* Linux, TLS 1.3: outgoing records are sealed by the kernel after the handshake. */
+            int                                                             MinVersion = TLS1_3_VERSION;
+            int                                                             MaxVersion = TLS1_3_VERSION;
+            std::string                                                     Groups;                 /* Key exchange groups in preference order, see GetSslGroups. */
+            std::string                                                     Ciphers;                /* TLS 1.2 cipher list in preference order, see GetSslCiphers. */
+        };
+
         class SSL final {
         public:
             typedef enum {
@@ -25,6 +34,11 @@ namespace uds {
                 const std::string&                                          certificate_key_file,
                 const std::string&                                          certificate_chain_file) noexcept;
             static const char*                                              GetSslCiphersuites() noexcept;
+            static const char*                                              GetSslCiphers() noexcept;
+            static const char*                                              GetSslGroups() noexcept;
+            static int                                                      GetSslVersion(const std::string& name, int default_version) noexcept;
+            /* Whether this CPU has AES-NI or the ARMv8 AES extensions, AES-GCM then outruns ChaCha20-Poly1305 and leads the suite order. */
+            static bool                                                     IsAesGcmFaster() noexcept;
 
         public:
             static std::shared_ptr<boost::asio::ssl::context>               CreateServerSslContext(
@@ -38,6 +52,29 @@ namespace uds {
                 int                                                         method,
                 bool                                                        verify_peer,
                 const std::string&                                          ciphersuites) noexcept;
+
+        public:
+            /* One context per set of parameters for the whole process, so the server's ticket keys and the client's tickets outlive a connection.
+               The server context is reloaded by ReloadSslContexts, connections keep the generation they started with. */
+            static std::shared_ptr<boost::asio::ssl::context>               GetServerSslContext(
+                int                                                         method,
+                const std::string&                                          certificate_file,
+                const std::string&                                          certificate_key_file,
+                const std::string&                                          certificate_chain_file,
+                const std::string&                                          certificate_key_password,
+                const std::string&                                          ciphersuites,
+                const SslOptions&                                           options) noexcept;
+            static std::shared_ptr<boost::asio::ssl::context>               GetClientSslContext(
+                int                                                         method,
+                bool                                                        verify_peer,
+                const std::string&                                          ciphersuites,
+                const SslOptions&                                           options) noexcept;
+            /* Builds a new generation of every server context whose files changed since the last call, meant for one periodic timer off the accept path. */
+            static void                                                     ReloadSslContexts() noexcept;
+            /* Offers a ticket an earlier handshake on the same shared client context was given, false leaves a full handshake. */
+            static bool                                                     ResumeSslSession(::SSL* ssl) noexcept;
+            /* Hands the write direction of a finished handshake on a context with KernelTls to the socket, false leaves it to OpenSSL. */
+            static bool                                                     EnableKernelTls(::SSL* ssl, int fd) noexcept;
         };
     }
 }
\ No newline at end of file
@@ -14,7 +14,8 @@
 #endif
 
 namespace uds {
-    static Random GLOBAL_RANDOBJECT;
+    /* One engine per thread, the handshake padding and keep-alive timers of every context draw from it without a lock. */
+    static thread_local FastRandom GLOBAL_RANDOBJECT;
 
     void SetThreadPriorityToMaxLevel() noexcept {
 #ifdef _WIN32
@@ -130,12 +131,25 @@ namespace uds {
     }
 
     Char RandomAscii() noexcept {
-        static const int m_ = 3;
-        static Byte x_[m_] = { 'a', 'A', '0' };
-        static Byte y_[m_] = { 'z', 'Z', '9' };
+        Char ch;
+        GLOBAL_RANDOBJECT.FillAscii(&ch, 1);
+        return ch;
+    }
+
+    void RandomAscii(Char* buffer, int length) noexcept {
+        if (NULL != buffer && length > 0) {
+            GLOBAL_RANDOBJECT.FillAscii(buffer, length);
+        }
+    }
+
+    void RandomFill(void* buffer, int length) noexcept {
+        if (NULL != buffer && length > 0) {
+            GLOBAL_RANDOBJECT.Fill(buffer, length);
+        }
+    }
 
-        int i_ = abs(GLOBAL_RANDOBJECT.Next()) % m_;
-        return (Char)GLOBAL_RANDOBJECT.Next(x_[i_], y_[i_]);
+    uint64_t RandomNextUInt64() noexcept {
+        return GLOBAL_RANDOBJECT.NextUInt64();
     }
 
     int RandomNext() noexcept {
@@ -50,6 +50,7 @@
 #include <memory>
 #include <string>
 #include <list>
+#include <deque>
 #include <map>
 #include <set>
 #include <regex>
@@ -292,11 +293,23 @@ namespace uds {
         return (T)(((uint64_t)size + alignment - 1) & ~(alignment - 1));
     }
 
+#ifdef UDS_MALLOC_STATISTICS
+    /* Counts Malloc calls for the benchmark target, compiled out of the service. */
+    inline std::atomic<uint64_t>&                                           MallocCount() noexcept {
+        static std::atomic<uint64_t> count(0);
+        return count;
+    }
+#endif
+
     inline void*                                                            Malloc(size_t size) noexcept {
         if (!size) {
             return NULL;
         }
 
+#ifdef UDS_MALLOC_STATISTICS
+        MallocCount()++;
+#endif
+
         size = Malign(size, 16);
 #ifdef JEMALLOC
         return (void*)::je_malloc(size);
@@ -675,6 +688,12 @@ namespace uds {
 
     Char                                                                    RandomAscii() noexcept;
 
+    void                                                                    RandomAscii(Char* buffer, int length) noexcept;
+
+    void                                                                    RandomFill(void* buffer, int length) noexcept;
+
+    uint64_t                                                                RandomNextUInt64() noexcept;
+
     int                                                                     RandomNext() noexcept;
 
     int                                                                     RandomNext(int minValue, int maxValue) noexcept;
@@ -2,8 +2,47 @@
 
 namespace uds {
     namespace threading {
+        /* Intrusive free list of relay chunks, the link lives in the first bytes of each idle chunk. */
+        static thread_local Byte*                                       buffers_ = NULL;
+        static thread_local int                                         buffers_count_ = 0;
+        static thread_local bool                                        buffers_closed_ = false;
+
+        /* Drains the free list when its thread exits, chunks released on that thread afterwards go straight back to the heap. */
+        class BufferPoolCleaner final {
+        public:
+            inline void                                                 Attach() noexcept {}
+            inline ~BufferPoolCleaner() noexcept {
+                buffers_closed_ = true;
+                while (Byte* chunk = buffers_) {
+                    buffers_ = *(Byte**)chunk;
+                    Mfree(chunk);
+                }
+                buffers_count_ = 0;
+            }
+        };
+        static thread_local BufferPoolCleaner                           buffers_cleaner_;
+
+        Hosting::Hosting() noexcept
+            : now_(0)
+            , next_(0)
+            , crypto_concurrent_(0)
+            , queue_high_water_(0) {
+
+        }
+
+        void Hosting::ReportQueueDepth(int depth) noexcept {
+            int high_water = queue_high_water_;
+            while (depth > high_water && !queue_high_water_.compare_exchange_weak(high_water, depth)) {
+                continue;
+            }
+        }
+
         bool Hosting::Run(std::function<void()> entryPoint) noexcept {
-            if (context_ || buffer_) {
+            return Run(1, std::move(entryPoint));
+        }
+
+        bool Hosting::Run(int concurrent, std::function<void()> entryPoint) noexcept {
+            if (context_) {
                 return false;
             }
 
@@ -12,12 +51,15 @@ namespace uds {
                 return false;
             }
 
-            buffer_ = make_shared_alloc<Byte>(BufferSize);
-            if (!buffer_) {
+            /* The main context is the first worker, the remaining workers each own an io_context and a thread. */
+            contexts_.push_back(context_);
+            if (!RunAllWorkers(concurrent)) {
+                JoinAllWorkers();
                 return false;
             }
 
             if (!OpenTimeout()) {
+                JoinAllWorkers();
                 return false;
             }
 
@@ -25,12 +67,101 @@ namespace uds {
                 context_->post(std::move(entryPoint));
             }
 
-            boost::system::error_code ec_;
-            boost::asio::io_context::work work_(*context_);
-            context_->run(ec_);
+            do {
+                boost::system::error_code ec_;
+                boost::asio::io_context::work work_(*context_);
+                context_->run(ec_);
+            } while (0);
+
+            JoinAllWorkers();
             return true;
         }
 
+        void Hosting::Exit() noexcept {
+            /* Run returns once the main context stops, it then stops and joins every other worker. */
+            const std::shared_ptr<boost::asio::io_context> context = context_;
+            if (context) {
+                context->stop();
+            }
+        }
+
+        void Hosting::JoinAllWorkers() noexcept {
+            for (const ContextPtr& context : contexts_) {
+                context->stop();
+            }
+
+            if (crypto_) {
+                crypto_->stop();
+            }
+
+            for (std::thread& worker : workers_) {
+                if (worker.joinable()) {
+                    worker.join();
+                }
+            }
+            workers_.clear();
+        }
+
+        bool Hosting::RunAllWorkers(int concurrent) noexcept {
+            for (int i = 1; i < concurrent; i++) {
+                std::shared_ptr<boost::asio::io_context> context = make_shared_object<boost::asio::io_context>();
+                if (!context) {
+                    return false;
+                }
+
+                std::thread worker(
+                    [context]() noexcept {
+                        SetThreadPriorityToMaxLevel();
+
+                        boost::system::error_code ec_;
+                        boost::asio::io_context::work work_(*context);
+                        context->run(ec_);
+                    });
+                workers_.emplace_back(std::move(worker));
+                contexts_.push_back(context);
+            }
+            return true;
+        }
+
+        bool Hosting::OpenCryptoWorkers(int concurrent) noexcept {
+            if (crypto_) {
+                return false;
+            }
+            elif(concurrent < 1) {
+                return true;
+            }
+
+            std::shared_ptr<boost::asio::io_context> context = make_shared_object<boost::asio::io_context>(concurrent);
+            if (!context) {
+                return false;
+            }
+
+            /* One context drained by every crypto worker, each transmission serializes its own jobs on a strand. */
+            for (int i = 0; i < concurrent; i++) {
+                std::thread worker(
+                    [context]() noexcept {
+                        boost::system::error_code ec_;
+                        boost::asio::io_context::work work_(*context);
+                        context->run(ec_);
+                    });
+                workers_.emplace_back(std::move(worker));
+            }
+
+            crypto_ = std::move(context);
+            crypto_concurrent_ = concurrent;
+            return true;
+        }
+
+        std::shared_ptr<boost::asio::io_context> Hosting::GetAnyContext() noexcept {
+            std::size_t concurrent = contexts_.size();
+            if (concurrent < 2) {
+                return context_;
+            }
+
+            unsigned int index = next_++;
+            return contexts_[index % concurrent];
+        }
+
         bool Hosting::OpenTimeout() noexcept {
             if (timeout_ || !context_) {
                 return true;
@@ -71,9 +202,41 @@ namespace uds {
         }
 
         void Hosting::Cancel(const std::shared_ptr<boost::asio::deadline_timer>& timeout) noexcept {
-            if (timeout) {
-                Cancel(*timeout);
+            /* A timer belongs to the thread of its context, cancelling it from another worker is handed over to that thread. */
+            const std::shared_ptr<boost::asio::deadline_timer> timer = timeout;
+            if (timer) {
+                boost::asio::dispatch(timer->get_executor(),
+                    [timer]() noexcept {
+                        Cancel(*timer);
+                    });
             }
         }
+
+        std::shared_ptr<Byte> Hosting::RentBuffer() noexcept {
+            Byte* chunk = buffers_;
+            if (chunk) {
+                buffers_ = *(Byte**)chunk;
+                buffers_count_--;
+            }
+            else {
+                chunk = (Byte*)Malloc(BufferSize);
+                if (!chunk) {
+                    return NULL;
+                }
+            }
+
+            return std::shared_ptr<Byte>(chunk,
+                [](Byte* chunk) noexcept {
+                    if (buffers_closed_ || buffers_count_ >= BufferPoolSize) {
+                        Mfree(chunk);
+                    }
+                    else {
+                        buffers_cleaner_.Attach();
+                        *(Byte**)chunk = buffers_;
+                        buffers_ = chunk;
+                        buffers_count_++;
+                    }
+                });
+        }
     }
 }
\ No newline at end of file
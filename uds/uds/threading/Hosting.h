@@ -8,22 +8,46 @@ namespace uds {
             typedef std::shared_ptr<boost::asio::io_context>            ContextPtr;
             typedef std::mutex                                          Mutex;
             typedef std::lock_guard<Mutex>                              MutexScope;
-            typedef std::list<ContextPtr>                               ContextList;
-            typedef std::shared_ptr<Byte>                               ChunkPtr;
-            typedef std::unordered_map<void*, ChunkPtr>                 ChunkTable;
+            typedef std::vector<std::thread>                            ThreadList;
+
+        public:
+            typedef std::vector<ContextPtr>                             ContextList;
 
         public:
             static const int                                            BufferSize = 65535;
+            static const int                                            BufferPoolSize = 32;
+
+        public:
+            Hosting() noexcept;
 
         public:
             inline const std::shared_ptr<boost::asio::io_context>&      GetContext() noexcept {
                 return context_;
             }
-            inline const std::shared_ptr<Byte>&                         GetBuffer() noexcept {
-                return buffer_;
+            inline const ContextList&                                   GetContexts() noexcept {
+                return contexts_;
+            }
+            inline int                                                  GetConcurrency() noexcept {
+                return (int)contexts_.size();
             }
+            /* Shared by the crypto workers, NULL while cipher work runs inline on the socket contexts. */
+            inline const std::shared_ptr<boost::asio::io_context>&      GetCryptoContext() noexcept {
+                return crypto_;
+            }
+            inline int                                                  GetCryptoConcurrency() noexcept {
+                return crypto_concurrent_;
+            }
+            /* Deepest send queue any transmission of this process has reached. */
+            inline int                                                  GetQueueHighWaterMark() noexcept {
+                return queue_high_water_;
+            }
+            void                                                        ReportQueueDepth(int depth) noexcept;
+            bool                                                        OpenCryptoWorkers(int concurrent) noexcept;
+            std::shared_ptr<boost::asio::io_context>                    GetAnyContext() noexcept;
             bool                                                        OpenTimeout() noexcept;
             bool                                                        Run(std::function<void()> entryPoint) noexcept;
+            bool                                                        Run(int concurrent, std::function<void()> entryPoint) noexcept;
+            void                                                        Exit() noexcept;
 
         public:
             inline uint64_t                                             CurrentMillisec() noexcept {
@@ -93,14 +117,25 @@ namespace uds {
             static void                                                 Cancel(const boost::asio::deadline_timer& timeout) noexcept;
             static void                                                 Cancel(const std::shared_ptr<boost::asio::deadline_timer>& timeout) noexcept;
 
+        public:
+            /* Rents a BufferSize chunk from the calling thread's pool, it returns to the pool of the thread dropping the last reference. */
+            static std::shared_ptr<Byte>                                RentBuffer() noexcept;
+
         private:
             bool                                                        AwaitTimeoutAsync() noexcept;
+            bool                                                        RunAllWorkers(int concurrent) noexcept;
+            void                                                        JoinAllWorkers() noexcept;
 
         private:
-            uint64_t                                                    now_;
-            std::shared_ptr<Byte>                                       buffer_;
+            std::atomic<uint64_t>                                       now_;
+            std::atomic<unsigned int>                                   next_;
+            ContextList                                                 contexts_;
+            ThreadList                                                  workers_;
             std::shared_ptr<boost::asio::io_context>                    context_;
             std::shared_ptr<boost::asio::deadline_timer>                timeout_;
+            std::shared_ptr<boost::asio::io_context>                    crypto_;
+            int                                                         crypto_concurrent_;
+            std::atomic<int>                                            queue_high_water_;
         };
     }
 }
\ No newline at end of file
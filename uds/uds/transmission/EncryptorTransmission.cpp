@@ -1,4 +1,5 @@
 #include <uds/transmission/EncryptorTransmission.h>
+#include <openssl/rand.h>
 
 namespace uds {
     namespace transmission {
@@ -6,13 +7,69 @@ namespace uds {
             const std::shared_ptr<uds::threading::Hosting>&             hosting, 
             const std::shared_ptr<boost::asio::io_context>&             context, 
             const std::shared_ptr<boost::asio::ip::tcp::socket>&        socket,
-            const std::string&                                          method,
-            const std::string&                                          password,
+            const std::shared_ptr<uds::cryptography::EncryptorKey>&     key,
             int                                                         alignment) noexcept
             : Transmission(hosting, context, socket, alignment)
             , disposed_(false)
-            , encryptor_(method, password) {
-            
+            , encryptor_(key)
+            , pending_(0) {
+            /* The AEAD tag rides inside the frame, a full segment plus its tag must still fit the read limit. */
+            int overhead = encryptor_.GetTagSize();
+            if (overhead > 0) {
+                constantof(ETRANSMISSION_MSS) = std::min<int>(ETRANSMISSION_MSS + overhead, uds::threading::Hosting::BufferSize);
+            }
+
+            /* With crypto workers the in-place cipher work of this transmission runs in order on its own strand of the pool. */
+            const std::shared_ptr<boost::asio::io_context> crypto = hosting ? hosting->GetCryptoContext() : NULL;
+            if (crypto && encryptor_.SupportInPlace()) {
+                strand_ = make_shared_object<CryptoStrand>(crypto->get_executor());
+            }
+        }
+
+        bool EncryptorTransmission::HandshakeAsync(HandshakeType type, const BOOST_ASIO_MOVE_ARG(HandshakeAsyncCallback) callback) noexcept {
+            if (!encryptor_.IsAEAD()) {
+                return Transmission::HandshakeAsync(type, forward0f(callback));
+            }
+
+            const std::shared_ptr<boost::asio::ip::tcp::socket>& socket = GetSocket();
+            if (!socket || !callback || !socket->is_open()) {
+                return false;
+            }
+
+            /* Each side sends a random salt for the direction it encrypts and reads the salt of the direction it decrypts. */
+            const int salt_size = encryptor_.GetSaltSize();
+            const std::shared_ptr<Byte> salts = make_shared_alloc<Byte>(salt_size << 1);
+            if (!salts) {
+                return false;
+            }
+
+            Byte* local_salt = salts.get();
+            Byte* remote_salt = local_salt + salt_size;
+            if (RAND_bytes(local_salt, salt_size) < 1 || !encryptor_.SetSalt(local_salt, salt_size, 1)) {
+                return false;
+            }
+
+            const std::shared_ptr<ITransmission> reference_ = GetReference();
+            const HandshakeAsyncCallback callback_ = BOOST_ASIO_MOVE_CAST(HandshakeAsyncCallback)(constantof(callback));
+            boost::asio::async_write(*socket, boost::asio::buffer(local_salt, salt_size),
+                [reference_, this, salts](const boost::system::error_code& ec, std::size_t sz) noexcept {
+                    if (ec) {
+                        Close();
+                    }
+                });
+            boost::asio::async_read(*socket, boost::asio::buffer(remote_salt, salt_size),
+                [reference_, this, salts, remote_salt, salt_size, callback_](const boost::system::error_code& ec, std::size_t sz) noexcept {
+                    bool success = !ec && encryptor_.SetSalt(remote_salt, salt_size, 0);
+                    if (!success) {
+                        Close();
+                    }
+                    callback_(success);
+                });
+            return true;
+        }
+
+        int EncryptorTransmission::GetMaxSegmentSize() noexcept {
+            return ETRANSMISSION_MSS - encryptor_.GetTagSize();
         }
 
         bool EncryptorTransmission::WriteAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept {
@@ -20,19 +77,65 @@ namespace uds {
                 return false;
             }
 
-            int outlen;
-            const std::shared_ptr<Byte> packet = encryptor_.Encrypt(buffer.get() + offset, length, outlen);
-            if (!packet || outlen < 1) {
+            if (!GetSocket()->is_open()) {
                 return false;
             }
 
-            const WriteAsyncCallback callback_ = BOOST_ASIO_MOVE_CAST(WriteAsyncCallback)(constantof(callback));
-            return Transmission::WriteAsync(packet, 0, outlen,
-                [callback_](bool success) noexcept {
-                    if (callback_) {
-                        callback_(success);
+            /* Relay payloads too long for a frame and its tag are sealed as several frames, a message of up to alignment bytes always fits one, see AppConfiguration. */
+            const int max_segment_size = GetMaxSegmentSize();
+            if (encryptor_.SupportInPlace()) {
+                while (length > 0) {
+                    int segment_size = std::min<int>(length, max_segment_size);
+                    bool success = false;
+                    if (length > segment_size) {
+                        success = EncryptAsync(buffer, offset, segment_size, NULL);
                     }
-                });
+                    else {
+                        success = EncryptAsync(buffer, offset, segment_size, forward0f(callback));
+                    }
+
+                    if (!success) {
+                        return false;
+                    }
+
+                    offset += segment_size;
+                    length -= segment_size;
+                }
+                return true;
+            }
+
+            const WriteAsyncCallback callback_ = BOOST_ASIO_MOVE_CAST(WriteAsyncCallback)(constantof(callback));
+            Byte* data = buffer.get() + offset;
+            while (length > 0) {
+                int segment_size = std::min<int>(length, max_segment_size);
+                int outlen;
+
+                const std::shared_ptr<Byte> packet = encryptor_.Encrypt(data, segment_size, outlen);
+                if (!packet || outlen < 1) {
+                    return false;
+                }
+
+                data += segment_size;
+                length -= segment_size;
+
+                bool success = false;
+                if (length > 0) {
+                    success = Transmission::WriteAsync(packet, 0, outlen, NULL);
+                }
+                else {
+                    success = Transmission::WriteAsync(packet, 0, outlen,
+                        [callback_](bool success) noexcept {
+                            if (callback_) {
+                                callback_(success);
+                            }
+                        });
+                }
+
+                if (!success) {
+                    return false;
+                }
+            }
+            return true;
         }
         
         bool EncryptorTransmission::ReadAsync(const BOOST_ASIO_MOVE_ARG(ReadAsyncCallback) callback) noexcept {
@@ -48,6 +151,11 @@ namespace uds {
                         return;
                     }
 
+                    if (encryptor_.SupportInPlace()) {
+                        DecryptAsync(buffer, length, callback_);
+                        return;
+                    }
+
                     int outlen;
                     const std::shared_ptr<Byte> packet = encryptor_.Decrypt(buffer.get(), length, outlen);
                     if (!packet || outlen < 1) {
@@ -58,5 +166,85 @@ namespace uds {
                     }
                 });
         }
+
+        bool EncryptorTransmission::Relocate(const std::shared_ptr<boost::asio::io_context>& context) noexcept {
+            /* Jobs in flight post their completions to the context of this transmission, it cannot change under them. */
+            if (pending_) {
+                return context == GetContext();
+            }
+            return Transmission::Relocate(context);
+        }
+
+        bool EncryptorTransmission::EncryptAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept {
+            /* The caller's buffer is encrypted where it lies and framed as is, the tag travels as the frame trailer. */
+            const int tag_size = encryptor_.GetTagSize();
+            if (!strand_) {
+                Byte tag[ETRANSMISSION_TRAILER];
+                if (encryptor_.EncryptInPlace(buffer.get() + offset, length, tag) != length) {
+                    return false;
+                }
+                return OnAddWriteAsync(buffer, offset, length, tag, tag_size, forward0f(callback));
+            }
+
+            /* Jobs leave the strand in submission order and are posted back in that order, so frames keep their nonce order. */
+            const std::shared_ptr<ITransmission> reference_ = GetReference();
+            const WriteAsyncCallback callback_ = BOOST_ASIO_MOVE_CAST(WriteAsyncCallback)(constantof(callback));
+            pending_++;
+            boost::asio::post(*strand_,
+                [reference_, this, buffer, offset, length, tag_size, callback_]() noexcept {
+                    std::array<Byte, ETRANSMISSION_TRAILER> tag;
+                    bool success = encryptor_.EncryptInPlace(buffer.get() + offset, length, tag.data()) == length;
+
+                    const std::shared_ptr<boost::asio::io_context> context = GetContext();
+                    boost::asio::post(*context,
+                        [reference_, this, buffer, offset, length, tag_size, callback_, tag, success]() noexcept {
+                            pending_--;
+
+                            WriteAsyncCallback callback = callback_;
+                            if (success && OnAddWriteAsync(buffer, offset, length, tag.data(), tag_size, std::move(callback))) {
+                                return;
+                            }
+
+                            Close();
+                            if (callback_) {
+                                callback_(false);
+                            }
+                        });
+                });
+            return true;
+        }
+
+        void EncryptorTransmission::DecryptAsync(const std::shared_ptr<Byte>& buffer, int length, const ReadAsyncCallback& callback) noexcept {
+            /* The rented receive buffer is decrypted in place, the tag at its end is simply dropped from the length. */
+            if (!strand_) {
+                int outlen = encryptor_.DecryptInPlace(buffer.get(), length);
+                if (outlen < 1) {
+                    callback(NULL, -1);
+                }
+                else {
+                    callback(buffer, outlen);
+                }
+                return;
+            }
+
+            const std::shared_ptr<ITransmission> reference_ = GetReference();
+            pending_++;
+            boost::asio::post(*strand_,
+                [reference_, this, buffer, length, callback]() noexcept {
+                    int outlen = encryptor_.DecryptInPlace(buffer.get(), length);
+
+                    const std::shared_ptr<boost::asio::io_context> context = GetContext();
+                    boost::asio::post(*context,
+                        [reference_, this, buffer, outlen, callback]() noexcept {
+                            pending_--;
+                            if (outlen < 1) {
+                                callback(NULL, -1);
+                            }
+                            else {
+                                callback(buffer, outlen);
+                            }
+                        });
+                });
+        }
     }
 }
\ No newline at end of file
@@ -11,17 +11,28 @@ namespace uds {
                 const std::shared_ptr<uds::threading::Hosting>&             hosting, 
                 const std::shared_ptr<boost::asio::io_context>&             context, 
                 const std::shared_ptr<boost::asio::ip::tcp::socket>&        socket,
-                const std::string&                                          method,
-                const std::string&                                          password, 
+                const std::shared_ptr<uds::cryptography::EncryptorKey>&     key,
                 int                                                         alignment) noexcept;
 
         public:
+            virtual bool                                                    HandshakeAsync(HandshakeType type, const BOOST_ASIO_MOVE_ARG(HandshakeAsyncCallback) callback) noexcept override;
             virtual bool                                                    WriteAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept override;
             virtual bool                                                    ReadAsync(const BOOST_ASIO_MOVE_ARG(ReadAsyncCallback) callback) noexcept override;
+            virtual bool                                                    Relocate(const std::shared_ptr<boost::asio::io_context>& context) noexcept override;
+            virtual int                                                     GetMaxSegmentSize() noexcept override;
+
+        private:
+            bool                                                            EncryptAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept;
+            void                                                            DecryptAsync(const std::shared_ptr<Byte>& buffer, int length, const ReadAsyncCallback& callback) noexcept;
+
+        private:
+            using CryptoStrand                                              = boost::asio::strand<boost::asio::io_context::executor_type>;
 
         private:
             std::atomic<bool>                                               disposed_;
             uds::cryptography::Encryptor                                    encryptor_;
+            std::shared_ptr<CryptoStrand>                                   strand_;
+            int                                                             pending_;       /* Cipher jobs handed to the crypto pool and not yet completed. */
         };
     }
 }
\ No newline at end of file
@@ -36,8 +36,13 @@ namespace uds {
                 int                                                             offset, 
                 int                                                             length, 
                 const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback)                   callback) = 0;
+            /* Moves an idle transmission to another worker context, a stream layered above the socket stays bound to the executor it was created on and only accepts its own context. */
+            virtual bool                                                        Relocate(
+                const std::shared_ptr<boost::asio::io_context>&                 context) = 0;
 
         public:
+            /* Largest message WriteAsync still sends as a single frame, frame-oriented callers must not exceed it. */
+            virtual int                                                         GetMaxSegmentSize() = 0;
             virtual std::shared_ptr<boost::asio::io_context>                    GetContext() = 0;
             virtual uds::net::IPEndPoint                                        GetLocalEndPoint() = 0;
             virtual uds::net::IPEndPoint                                        GetRemoteEndPoint() = 0;
@@ -15,16 +15,19 @@ namespace uds {
             const std::string&                                      certificate_chain_file,
             const std::string&                                      certificate_key_password,
             const std::string&                                      ciphersuites,
+            const uds::ssl::SslOptions&                             options,
             int                                                     alignment) noexcept
             : Transmission(hosting, context, socket, alignment)
             , disposed_(false)
             , verify_peer_(verify_peer)
+            , kernel_tls_(false)
             , host_(host)
             , certificate_file_(certificate_file)
             , certificate_key_file_(certificate_key_file)
             , certificate_chain_file_(certificate_chain_file)
             , certificate_key_password_(certificate_key_password)
-            , ciphersuites_(ciphersuites) {
+            , ciphersuites_(ciphersuites)
+            , options_(options) {
 
         }
 
@@ -35,6 +38,7 @@ namespace uds {
             bool                                                    verify_peer,
             const std::string&                                      host,
             const std::string&                                      ciphersuites,
+            const uds::ssl::SslOptions&                             options,
             int                                                     alignment) noexcept
             : SslSocketTransmission(
                 hosting, 
@@ -47,6 +51,7 @@ namespace uds {
                 "", 
                 "", 
                 ciphersuites,
+                options,
                 alignment) {
             
         }
@@ -61,6 +66,7 @@ namespace uds {
             const std::string&                                      certificate_chain_file,
             const std::string&                                      certificate_key_password,
             const std::string&                                      ciphersuites,
+            const uds::ssl::SslOptions&                             options,
             int                                                     alignment) noexcept
             : SslSocketTransmission(
                 hosting,
@@ -73,26 +79,42 @@ namespace uds {
                 certificate_chain_file,
                 certificate_key_password,
                 ciphersuites,
+                options,
                 alignment) {
         
         }
 
-        bool SslSocketTransmission::OnWriteAsync(const BOOST_ASIO_MOVE_ARG(pmessage) message) noexcept {
+        bool SslSocketTransmission::OnWriteAsync(const message_buffers& buffers) noexcept {
             const std::shared_ptr<ITransmission> reference = GetReference();
-            const pmessage messages = BOOST_ASIO_MOVE_CAST(pmessage)(constantof(message));
 
-            boost::asio::async_write(*ssl_socket_, boost::asio::buffer(messages->packet.get(), messages->packet_size),
-                [reference, this, messages](const boost::system::error_code& ec, size_t sz) noexcept {
-                    bool success = ec ? false : true;
-                    if (!success) {
-                        Close();
-                    }
+            /* With kernel TLS the socket seals the records itself, the frame is gathered straight into it. */
+            if (kernel_tls_) {
+                boost::asio::async_write(ssl_socket_->next_layer(), buffers,
+                    [reference, this](const boost::system::error_code& ec, size_t sz) noexcept {
+                        OnWriteCompleted(ec ? false : true);
+                    });
+                return true;
+            }
 
-                    const WriteAsyncCallback& callback = messages->callback;
-                    if (callback) {
-                        callback(success);
-                    }
-                    OnAsyncWrite(true);
+            /* SSL_write takes one buffer at a time, a gathered write would seal every piece in a record of its own. */
+            std::size_t packet_size = boost::asio::buffer_size(buffers);
+            std::shared_ptr<Byte> packet;
+            if (packet_size <= uds::threading::Hosting::BufferSize) {
+                packet = uds::threading::Hosting::RentBuffer();
+            }
+
+            if (!packet) {
+                boost::asio::async_write(*ssl_socket_, buffers,
+                    [reference, this](const boost::system::error_code& ec, size_t sz) noexcept {
+                        OnWriteCompleted(ec ? false : true);
+                    });
+                return true;
+            }
+
+            boost::asio::buffer_copy(boost::asio::buffer(packet.get(), packet_size), buffers);
+            boost::asio::async_write(*ssl_socket_, boost::asio::buffer(packet.get(), packet_size),
+                [reference, this, packet](const boost::system::error_code& ec, size_t sz) noexcept {
+                    OnWriteCompleted(ec ? false : true);
                 });
             return true;
         }
@@ -103,6 +125,11 @@ namespace uds {
                 if (!ssl_socket) {
                     Transmission::Dispose();
                 }
+                elif(kernel_tls_) {
+                    /* OpenSSL no longer knows the write sequence, a close_notify from it would be garbage to the peer. */
+                    Transmission::Dispose();
+                    uds::net::Socket::Closesocket(ssl_socket->next_layer());
+                }
                 else {
                     const std::shared_ptr<ITransmission> reference = GetReference();
                     ssl_socket->async_shutdown(
@@ -132,8 +159,9 @@ namespace uds {
                     std::string& certificate_key_file,
                     std::string& certificate_chain_file,
                     std::string& certificate_key_password,
-                    std::string& ciphersuites) noexcept
-                    : SslSocket(tcp_socket, ssl_context, ssl_socket, verify_peer, host, certificate_file, certificate_key_file, certificate_chain_file, certificate_key_password, ciphersuites)
+                    std::string& ciphersuites,
+                    uds::ssl::SslOptions& options) noexcept
+                    : SslSocket(tcp_socket, ssl_context, ssl_socket, verify_peer, host, certificate_file, certificate_key_file, certificate_chain_file, certificate_key_password, ciphersuites, options)
                     , transmission_(transmission) {
 
                 }
@@ -164,6 +192,9 @@ namespace uds {
                             if (!success) {
                                 Close();
                             }
+                            elif(options_.KernelTls && transmission_) {
+                                transmission_->kernel_tls_ = uds::ssl::SSL::EnableKernelTls(GetSslHandle(), GetSslSocket()->next_layer().native_handle());
+                            }
 
                             callback_(success);
                         });
@@ -176,7 +207,7 @@ namespace uds {
 
             std::shared_ptr<SslSocketTransmission> transmission = Reference::CastReference<SslSocketTransmission>(GetReference());
             std::shared_ptr<AsyncSslSocket> accept =
-                Reference::NewReference<AsyncSslSocket>(transmission, GetSocket(), ssl_context_, ssl_socket_, verify_peer_, host_, certificate_file_, certificate_key_file_, certificate_chain_file_, certificate_key_password_, ciphersuites_);
+                Reference::NewReference<AsyncSslSocket>(transmission, GetSocket(), ssl_context_, ssl_socket_, verify_peer_, host_, certificate_file_, certificate_key_file_, certificate_chain_file_, certificate_key_password_, ciphersuites_, options_);
             return accept->HandshakeAsync(type, forward0f(callback));
         }
         
@@ -190,13 +221,7 @@ namespace uds {
                 return false;
             }
 
-            pmessage messages = Pack(buffer.get(), offset, length, forward0f(callback));
-            if (!messages) {
-                return false;
-            }
-
-            OnAddWriteAsync(forward0f(messages));
-            return true;
+            return OnAddWriteAsync(buffer, offset, length, forward0f(callback));
         }
        
         bool SslSocketTransmission::ReadAsync(const BOOST_ASIO_MOVE_ARG(ReadAsyncCallback) callback) noexcept {
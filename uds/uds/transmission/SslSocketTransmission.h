@@ -1,6 +1,7 @@
 #pragma once
 
 #include <uds/transmission/Transmission.h>
+#include <uds/ssl/SSL.h>
 
 namespace uds {
     namespace transmission {
@@ -19,6 +20,7 @@ namespace uds {
                 const std::string&                                          certificate_chain_file,
                 const std::string&                                          certificate_key_password,
                 const std::string&                                          ciphersuites,
+                const uds::ssl::SslOptions&                                 options,
                 int                                                         alignment) noexcept;
 
         public:
@@ -29,6 +31,7 @@ namespace uds {
                 bool                                                        verify_peer,
                 const std::string&                                          host,
                 const std::string&                                          ciphersuites,
+                const uds::ssl::SslOptions&                                 options,
                 int                                                         alignment) noexcept;
 
             SslSocketTransmission(
@@ -41,6 +44,7 @@ namespace uds {
                 const std::string&                                          certificate_chain_file,
                 const std::string&                                          certificate_key_password,
                 const std::string&                                          ciphersuites,
+                const uds::ssl::SslOptions&                                 options,
                 int                                                         alignment) noexcept;
 
         public:
@@ -48,13 +52,17 @@ namespace uds {
             virtual bool                                                    HandshakeAsync(HandshakeType type, const BOOST_ASIO_MOVE_ARG(HandshakeAsyncCallback) callback) noexcept override;
             virtual bool                                                    WriteAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept override;
             virtual bool                                                    ReadAsync(const BOOST_ASIO_MOVE_ARG(ReadAsyncCallback) callback) noexcept override;
+            inline virtual bool                                             Relocate(const std::shared_ptr<boost::asio::io_context>& context) noexcept override {
+                return context == GetContext();
+            }
 
         protected:
-            virtual bool                                                    OnWriteAsync(const BOOST_ASIO_MOVE_ARG(pmessage) message) noexcept override;
+            virtual bool                                                    OnWriteAsync(const message_buffers& buffers) noexcept override;
 
         private:
             std::atomic<bool>                                               disposed_;
             bool                                                            verify_peer_;
+            bool                                                            kernel_tls_;
             std::shared_ptr<boost::asio::ssl::context>                      ssl_context_;
             std::shared_ptr<SslSocket>                                      ssl_socket_;
             std::string                                                     host_;
@@ -63,6 +71,7 @@ namespace uds {
             std::string                                                     certificate_chain_file_;
             std::string                                                     certificate_key_password_;
             std::string                                                     ciphersuites_;
+            uds::ssl::SslOptions                                            options_;
         };
     }
 }
\ No newline at end of file
@@ -17,6 +17,7 @@ namespace uds {
             const std::string&                                          certificate_chain_file,
             const std::string&                                          certificate_key_password,
             const std::string&                                          ciphersuites,
+            const uds::ssl::SslOptions&                                 options,
             int                                                         alignment) noexcept
             : Transmission(hosting, context, socket, alignment)
             , disposed_(false)
@@ -27,7 +28,8 @@ namespace uds {
             , certificate_key_file_(certificate_key_file)
             , certificate_chain_file_(certificate_chain_file)
             , certificate_key_password_(certificate_key_password)
-            , ciphersuites_(ciphersuites) {
+            , ciphersuites_(ciphersuites)
+            , options_(options) {
             
         }
 
@@ -39,6 +41,7 @@ namespace uds {
             const std::string&                                          host,
             const std::string&                                          path,
             const std::string&                                          ciphersuites,
+            const uds::ssl::SslOptions&                                 options,
             int                                                         alignment) noexcept
             : SslWebSocketTransmission(
                 hosting,
@@ -52,6 +55,7 @@ namespace uds {
                 "",
                 "",
                 ciphersuites,
+                options,
                 alignment) {
         
         }
@@ -67,6 +71,7 @@ namespace uds {
             const std::string&                                          certificate_chain_file,
             const std::string&                                          certificate_key_password,
             const std::string&                                          ciphersuites,
+            const uds::ssl::SslOptions&                                 options,
             int                                                         alignment) noexcept
             : SslWebSocketTransmission(
                 hosting,
@@ -80,6 +85,7 @@ namespace uds {
                 certificate_chain_file,
                 certificate_key_password,
                 ciphersuites,
+                options,
                 alignment) {
         
         }
@@ -155,8 +161,9 @@ namespace uds {
                     std::string& certificate_key_file,
                     std::string& certificate_chain_file,
                     std::string& certificate_key_password,
-                    std::string& ciphersuites) noexcept
-                    : SslSocket(tcp_socket, ssl_context, ssl_websocket, verify_peer, host, certificate_file, certificate_key_file, certificate_chain_file, certificate_key_password, ciphersuites)
+                    std::string& ciphersuites,
+                    uds::ssl::SslOptions& options) noexcept
+                    : SslSocket(tcp_socket, ssl_context, ssl_websocket, verify_peer, host, certificate_file, certificate_key_file, certificate_chain_file, certificate_key_password, ciphersuites, options)
                     , path_(path)
                     , transmission_(transmission) {
 
@@ -215,26 +222,15 @@ namespace uds {
 
             std::shared_ptr<SslWebSocketTransmission> transmission = Reference::CastReference<SslWebSocketTransmission>(GetReference());
             std::shared_ptr<AsyncSslvWebSocket> accept =
-                Reference::NewReference<AsyncSslvWebSocket>(transmission, GetSocket(), ssl_context_, ssl_websocket_, verify_peer_, host_, path_, certificate_file_, certificate_key_file_, certificate_chain_file_, certificate_key_password_, ciphersuites_);
+                Reference::NewReference<AsyncSslvWebSocket>(transmission, GetSocket(), ssl_context_, ssl_websocket_, verify_peer_, host_, path_, certificate_file_, certificate_key_file_, certificate_chain_file_, certificate_key_password_, ciphersuites_, options_);
             return accept->HandshakeAsync(type, forward0f(callback));
         }
 
-        bool SslWebSocketTransmission::OnWriteAsync(const BOOST_ASIO_MOVE_ARG(pmessage) message) noexcept {
+        bool SslWebSocketTransmission::OnWriteAsync(const message_buffers& buffers) noexcept {
             const std::shared_ptr<ITransmission> reference = GetReference();
-            const pmessage messages = BOOST_ASIO_MOVE_CAST(pmessage)(constantof(message));
-
-            ssl_websocket_->async_write(boost::asio::buffer(messages->packet.get(), messages->packet_size),
-                [reference, this, messages](const boost::system::error_code& ec, size_t sz) noexcept {
-                    bool success = ec ? false : true;
-                    if (!success) {
-                        Close();
-                    }
-
-                    const WriteAsyncCallback& callback = messages->callback;
-                    if (callback) {
-                        callback(success);
-                    }
-                    OnAsyncWrite(true);
+            ssl_websocket_->async_write(buffers,
+                [reference, this](const boost::system::error_code& ec, size_t sz) noexcept {
+                    OnWriteCompleted(ec ? false : true);
                 });
             return true;
         }
@@ -244,13 +240,7 @@ namespace uds {
                 return false;
             }
 
-            pmessage messages = Pack(buffer.get(), offset, length, forward0f(callback));
-            if (!messages) {
-                return false;
-            }
-
-            OnAddWriteAsync(forward0f(messages));
-            return true;
+            return OnAddWriteAsync(buffer, offset, length, forward0f(callback));
         }
 
         bool SslWebSocketTransmission::ReadAsync(const BOOST_ASIO_MOVE_ARG(ReadAsyncCallback) callback) noexcept {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <uds/transmission/Transmission.h>
+#include <uds/ssl/SSL.h>
 
 namespace uds {
     namespace transmission {
@@ -22,6 +23,7 @@ namespace uds {
                 const std::string&                                          certificate_chain_file,
                 const std::string&                                          certificate_key_password,
                 const std::string&                                          ciphersuites,
+                const uds::ssl::SslOptions&                                 options,
                 int                                                         alignment) noexcept;
 
         public:
@@ -33,6 +35,7 @@ namespace uds {
                 const std::string&                                          host,
                 const std::string&                                          path,
                 const std::string&                                          ciphersuites,
+                const uds::ssl::SslOptions&                                 options,
                 int                                                         alignment) noexcept;
 
             SslWebSocketTransmission(
@@ -46,6 +49,7 @@ namespace uds {
                 const std::string&                                          certificate_chain_file,
                 const std::string&                                          certificate_key_password,
                 const std::string&                                          ciphersuites,
+                const uds::ssl::SslOptions&                                 options,
                 int                                                         alignment) noexcept;
 
         public:
@@ -53,9 +57,12 @@ namespace uds {
             virtual bool                                                    HandshakeAsync(HandshakeType type, const BOOST_ASIO_MOVE_ARG(HandshakeAsyncCallback) callback) noexcept override;
             virtual bool                                                    WriteAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept override;
             virtual bool                                                    ReadAsync(const BOOST_ASIO_MOVE_ARG(ReadAsyncCallback) callback) noexcept override;
+            inline virtual bool                                             Relocate(const std::shared_ptr<boost::asio::io_context>& context) noexcept override {
+                return context == GetContext();
+            }
 
         protected:
-            virtual bool                                                    OnWriteAsync(const BOOST_ASIO_MOVE_ARG(pmessage) message) noexcept override;
+            virtual bool                                                    OnWriteAsync(const message_buffers& buffers) noexcept override;
 
         private:
             std::atomic<bool>                                               disposed_;
@@ -69,6 +76,7 @@ namespace uds {
             std::string                                                     certificate_chain_file_;
             std::string                                                     certificate_key_password_;
             std::string                                                     ciphersuites_;
+            uds::ssl::SslOptions                                            options_;
         };
     }
 }
\ No newline at end of file
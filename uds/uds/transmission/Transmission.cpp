@@ -8,7 +8,12 @@ namespace uds {
             , hosting_(hosting)
             , context_(context)
             , socket_(socket)
-            , writing_(false) {
+            , writing_(false)
+            , coalescing_(uds::threading::Hosting::BufferSize)
+            , queue_high_water_(0)
+            , ring_head_(0)
+            , ring_count_(0)
+            , batch_count_(0) {
             typedef uds::net::IPEndPoint IPEndPoint;
 
             /* Format address enpoint. */
@@ -16,11 +21,10 @@ namespace uds {
             localEP_ = IPEndPoint::V6ToV4(IPEndPoint::ToEndPoint(socket->local_endpoint(ec)));
             remoteEP_ = IPEndPoint::V6ToV4(IPEndPoint::ToEndPoint(socket->remote_endpoint(ec)));
 
-            /* Alloc transmission receive buffers. */
+            /* Receive buffers are rented per read, see Unpack. */
             if (alignment >= (UINT8_MAX << 1) && alignment <= ETRANSMISSION_MSS) {
                 constantof(ETRANSMISSION_MSS) = alignment;
             }
-            buffer_ = make_shared_alloc<Byte>(ETRANSMISSION_MSS);
         }
 
         uds::net::IPEndPoint Transmission::GetLocalEndPoint() noexcept {
@@ -63,6 +67,10 @@ namespace uds {
             return true;
         }
 
+        int Transmission::GetMaxSegmentSize() noexcept {
+            return ETRANSMISSION_MSS;
+        }
+
         bool Transmission::ReadAsync(const BOOST_ASIO_MOVE_ARG(ReadAsyncCallback) callback) noexcept {
             if (!socket_->is_open()) {
                 return false;
@@ -76,49 +84,139 @@ namespace uds {
                 return false;
             }
 
-            pmessage messages = Pack(buffer.get(), offset, length, forward0f(callback));
-            if (!messages) {
+            return OnAddWriteAsync(buffer, offset, length, forward0f(callback));
+        }
+
+        bool Transmission::Relocate(const std::shared_ptr<boost::asio::io_context>& context) noexcept {
+            if (!context || !socket_ || disposed_) {
+                return false;
+            }
+            elif(context == context_) {
+                return true;
+            }
+
+            /* Only an idle transmission can move, the caller must not have any read in flight. */
+            if (writing_ || ring_count_ || !messages_.empty() || !socket_->is_open()) {
+                return false;
+            }
+
+            std::shared_ptr<boost::asio::ip::tcp::socket> socket = make_shared_object<boost::asio::ip::tcp::socket>(*context);
+            if (!socket) {
+                return false;
+            }
+
+            boost::system::error_code ec;
+            boost::asio::ip::tcp::endpoint localEP = socket_->local_endpoint(ec);
+            if (ec) {
                 return false;
             }
 
-            OnAddWriteAsync(forward0f(messages));
+            int handle = socket_->release(ec);
+            if (ec) {
+                return false;
+            }
+
+            socket->assign(localEP.protocol(), handle, ec);
+            if (ec) {
+                uds::net::Socket::Closesocket(handle);
+                return false;
+            }
+
+            socket_ = std::move(socket);
+            context_ = context;
             return true;
         }
 
-        void Transmission::OnAddWriteAsync(const BOOST_ASIO_MOVE_ARG(pmessage) message) noexcept {
-            const pmessage messages = BOOST_ASIO_MOVE_CAST(pmessage)(constantof(message));
+        bool Transmission::OnAddWriteAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept {
+            return OnAddWriteAsync(buffer, offset, length, NULL, 0, forward0f(callback));
+        }
+
+        bool Transmission::OnAddWriteAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const Byte* trailer, int trailer_size, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept {
+            if (!buffer || offset < 0 || length < 1 || trailer_size < 0 || trailer_size > ETRANSMISSION_TRAILER || (trailer_size && !trailer)) {
+                return false;
+            }
+            elif(length + trailer_size > ETRANSMISSION_MSS) {
+                return false;
+            }
+
+            /* Messages take a ring slot while the ring has room, the overflow list only keeps order once it is full. */
+            if (messages_.empty() && ring_count_ < ETRANSMISSION_RING) {
+                message& messages = ring_[(ring_head_ + ring_count_) % ETRANSMISSION_RING];
+                Pack(messages, buffer, offset, length, trailer, trailer_size, forward0f(callback));
+                ring_count_++;
+            }
+            else {
+                messages_.emplace_back();
+                Pack(messages_.back(), buffer, offset, length, trailer, trailer_size, forward0f(callback));
+            }
+
+            int depth = GetQueueDepth();
+            if (depth > queue_high_water_) {
+                queue_high_water_ = depth;
+                if (hosting_) {
+                    hosting_->ReportQueueDepth(depth);
+                }
+            }
 
-            messages_.push_back(messages);
             OnAsyncWrite(false);
+            return true;
         }
 
         void Transmission::Dispose() noexcept {
             if (!disposed_.exchange(true)) {
+                /* Drop what is queued, the slots of the batch in flight are released by its completion. */
+                for (int i = batch_count_; i < ring_count_; i++) {
+                    message& messages = ring_[(ring_head_ + i) % ETRANSMISSION_RING];
+                    messages.packet.reset();
+                    messages.callback = NULL;
+                }
+
+                ring_count_ = batch_count_;
                 messages_.clear();
                 uds::net::Socket::Closesocket(socket_);
             }
         }
 
-        bool Transmission::OnWriteAsync(const BOOST_ASIO_MOVE_ARG(pmessage) message) noexcept {
+        bool Transmission::OnWriteAsync(const message_buffers& buffers) noexcept {
             const std::shared_ptr<ITransmission> reference = GetReference();
-            const pmessage messages = BOOST_ASIO_MOVE_CAST(pmessage)(constantof(message));
-
-            boost::asio::async_write(*socket_, boost::asio::buffer(messages->packet.get(), messages->packet_size),
-                [reference, this, messages](const boost::system::error_code& ec, size_t sz) noexcept {
-                    bool success = ec ? false : true;
-                    if (!success) {
-                        Close();
-                    }
-
-                    const WriteAsyncCallback& callback = messages->callback;
-                    if (callback) {
-                        callback(success);
-                    }
-                    OnAsyncWrite(true);
+            boost::asio::async_write(*socket_, buffers,
+                [reference, this](const boost::system::error_code& ec, size_t sz) noexcept {
+                    OnWriteCompleted(ec ? false : true);
                 });
             return true;
         }
 
+        void Transmission::OnWriteCompleted(bool success) noexcept {
+            if (!success) {
+                Close();
+            }
+
+            /* Every message of the batch completes in queue order, its slot is released before the callback may queue again. */
+            batch_buffers_.clear();
+            while (batch_count_ > 0) {
+                message& messages = ring_[ring_head_];
+                WriteAsyncCallback callback = std::move(messages.callback);
+                messages.callback = NULL;
+                messages.packet.reset();
+
+                ring_head_ = (ring_head_ + 1) % ETRANSMISSION_RING;
+                ring_count_--;
+                batch_count_--;
+
+                if (callback) {
+                    callback(success);
+                }
+            }
+
+            /* Refill the freed slots from the overflow list. */
+            while (ring_count_ < ETRANSMISSION_RING && !messages_.empty()) {
+                ring_[(ring_head_ + ring_count_) % ETRANSMISSION_RING] = std::move(messages_.front());
+                messages_.pop_front();
+                ring_count_++;
+            }
+            OnAsyncWrite(true);
+        }
+
         bool Transmission::OnAsyncWrite(bool internall) noexcept {
             if (!internall) {
                 if (writing_.exchange(true)) { // ڶдҲڲ򷵻
@@ -126,38 +224,50 @@ namespace uds {
                 }
             }
 
-            message_queue::iterator tail = messages_.begin();
-            message_queue::iterator endl = messages_.end();
-            if (tail == endl) { // ǰϢǿյ
+            if (!ring_count_) { // ǰϢǿյ
                 writing_.exchange(false);
                 return false;
             }
 
-            std::shared_ptr<ITransmission> reference = GetReference();
-            pmessage message = std::move(*tail);
+            /* Gather the queued messages into one write, at least one message and otherwise no more than the coalescing budget. */
+            int batch_size = 0;
+            while (batch_count_ < ring_count_) {
+                message& messages = ring_[(ring_head_ + batch_count_) % ETRANSMISSION_RING];
+                int packet_size = ETRANSMISSION_TSS + messages.packet_size + messages.trailer_size;
+                if (batch_size > 0 && batch_size + packet_size > coalescing_) {
+                    break;
+                }
 
-            messages_.erase(tail); // ϢɾϢ
-            return OnWriteAsync(BOOST_ASIO_MOVE_CAST(pmessage)(message));
-        }
+                std::array<boost::asio::const_buffer, 3> buffers = messages.GetBuffers();
+                batch_buffers_.push_back(buffers[0]);
+                batch_buffers_.push_back(buffers[1]);
+                if (messages.trailer_size) {
+                    batch_buffers_.push_back(buffers[2]);
+                }
 
-        Transmission::pmessage Transmission::Pack(const void* buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept {
-            if (!buffer || offset < 0 || length < 1 || length > ETRANSMISSION_MSS) {
-                return NULL;
+                batch_size += packet_size;
+                batch_count_++;
             }
 
-            int packet_size_ = ETRANSMISSION_TSS + length;
-            std::shared_ptr<Byte> packet_ = make_shared_alloc<Byte>(packet_size_);
+            const boost::asio::const_buffer* buffers = batch_buffers_.data();
+            return OnWriteAsync(message_buffers(buffers, buffers + batch_buffers_.size()));
+        }
 
-            Byte* p_ = packet_.get();
-            p_[0] = (Byte)(length >> 8);
-            p_[1] = (Byte)(length);
-            memcpy(p_ + ETRANSMISSION_TSS, ((Byte*)buffer) + offset, length);
+        void Transmission::Pack(message& messages, const std::shared_ptr<Byte>& buffer, int offset, int length, const Byte* trailer, int trailer_size, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept {
+            /* The payload is referenced, not copied, the caller must not reuse it until the callback fires. */
+            int frame_size = length + trailer_size;
+            Byte* p_ = messages.header;
+            p_[0] = (Byte)(frame_size >> 8);
+            p_[1] = (Byte)(frame_size);
+            if (trailer_size) {
+                memcpy(messages.trailer, trailer, trailer_size);
+            }
 
-            pmessage messages = make_shared_object<message>();
-            messages->packet = packet_;
-            messages->packet_size = packet_size_;
-            messages->callback = BOOST_ASIO_MOVE_CAST(WriteAsyncCallback)(constantof(callback));
-            return messages;
+            messages.packet = buffer;
+            messages.packet_offset = offset;
+            messages.packet_size = length;
+            messages.trailer_size = trailer_size;
+            messages.callback = BOOST_ASIO_MOVE_CAST(WriteAsyncCallback)(constantof(callback));
         }
     }
 }
\ No newline at end of file
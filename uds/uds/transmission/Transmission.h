@@ -9,13 +9,50 @@ namespace uds {
         protected:
             const int ETRANSMISSION_TSS                             = 2;
             const int ETRANSMISSION_MSS                             = uds::threading::Hosting::BufferSize;
+            static const int ETRANSMISSION_RING                     = 8;
+            static const int ETRANSMISSION_TRAILER                  = 16;
+            /* A slot takes the moved callback and a reference to the payload, neither allocates, the overflow list allocates a node per message past the ring. */
             struct message {
+                Byte                                                header[2];
                 std::shared_ptr<Byte>                               packet;
+                int                                                 packet_offset;
                 int                                                 packet_size;
+                Byte                                                trailer[ETRANSMISSION_TRAILER];
+                int                                                 trailer_size;
                 WriteAsyncCallback                                  callback;
+
+                /* Length prefix, the caller's payload and an optional trailer such as an AEAD tag, gathered without copying. */
+                inline std::array<boost::asio::const_buffer, 3>     GetBuffers() noexcept {
+                    std::array<boost::asio::const_buffer, 3> buffers = { {
+                        boost::asio::buffer(header, sizeof(header)),
+                        boost::asio::buffer(packet.get() + packet_offset, packet_size),
+                        boost::asio::buffer(trailer, trailer_size) } };
+                    return buffers;
+                }
+            };
+            typedef std::list<message>                              message_queue;
+
+            /* View over the gathered buffers of the batch in flight, cheap to copy into a composed write operation. */
+            class message_buffers {
+            public:
+                typedef boost::asio::const_buffer                   value_type;
+                typedef const boost::asio::const_buffer*            const_iterator;
+
+            public:
+                inline message_buffers(const_iterator first, const_iterator last) noexcept
+                    : first_(first)
+                    , last_(last) {
+
+                }
+
+            public:
+                inline const_iterator                               begin() const noexcept { return first_; }
+                inline const_iterator                               end() const noexcept { return last_; }
+
+            private:
+                const_iterator                                      first_;
+                const_iterator                                      last_;
             };
-            typedef std::shared_ptr<message>                        pmessage;
-            typedef std::list<pmessage>                             message_queue;
 
         public:
             Transmission(const std::shared_ptr<uds::threading::Hosting>& hosting, const std::shared_ptr<boost::asio::io_context>& context, const std::shared_ptr<boost::asio::ip::tcp::socket>& socket, int alignment) noexcept;
@@ -24,21 +61,28 @@ namespace uds {
             inline const std::shared_ptr<uds::threading::Hosting>&  GetHosting() noexcept {
                 return hosting_;
             }
+            inline int                                              GetCoalescing() noexcept {
+                return coalescing_;
+            }
+            inline void                                             SetCoalescing(int coalescing) noexcept {
+                coalescing_ = coalescing;
+            }
+            /* Messages queued or in flight, only meaningful on the transmission's own context. */
+            inline int                                              GetQueueDepth() noexcept {
+                return ring_count_ + (int)messages_.size();
+            }
+            inline int                                              GetQueueHighWaterMark() noexcept {
+                return queue_high_water_;
+            }
+            virtual int                                             GetMaxSegmentSize() noexcept override;
             virtual std::shared_ptr<boost::asio::io_context>        GetContext() noexcept override;
             virtual bool                                            HandshakeAsync(HandshakeType type, const BOOST_ASIO_MOVE_ARG(HandshakeAsyncCallback) callback) noexcept override;
             virtual bool                                            ReadAsync(const BOOST_ASIO_MOVE_ARG(ReadAsyncCallback) callback) noexcept override;
             virtual bool                                            WriteAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept override;
+            virtual bool                                            Relocate(const std::shared_ptr<boost::asio::io_context>& context) noexcept override;
             virtual void                                            Dispose() noexcept override;
             virtual uds::net::IPEndPoint                            GetLocalEndPoint() noexcept override;
             virtual uds::net::IPEndPoint                            GetRemoteEndPoint() noexcept override;
-
-        protected:
-            inline std::shared_ptr<Byte>&                           GetBuffer() noexcept {
-                return buffer_;
-            }
-            inline std::shared_ptr<Byte>&                           SetBuffer(const std::shared_ptr<Byte>& buffer) noexcept {
-                return (buffer_ = buffer);
-            }
             inline std::shared_ptr<boost::asio::ip::tcp::socket>&   GetSocket() noexcept {
                 return socket_;
             }
@@ -48,9 +92,11 @@ namespace uds {
             void                                                    SetRemoteEndPoint(const uds::net::IPEndPoint& value) noexcept;
 
         protected:
-            void                                                    OnAddWriteAsync(const BOOST_ASIO_MOVE_ARG(pmessage) message) noexcept;
+            bool                                                    OnAddWriteAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept;
+            bool                                                    OnAddWriteAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const Byte* trailer, int trailer_size, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept;
             bool                                                    OnAsyncWrite(bool internall) noexcept;
-            virtual bool                                            OnWriteAsync(const BOOST_ASIO_MOVE_ARG(pmessage) message) noexcept;
+            void                                                    OnWriteCompleted(bool success) noexcept;
+            virtual bool                                            OnWriteAsync(const message_buffers& buffers) noexcept;
 
         protected:
             template<typename AsynchronousStream>
@@ -68,8 +114,9 @@ namespace uds {
                     callback(NULL, length);
                 };
 
+                /* Only the length prefix is awaited in place, the payload buffer is rented once it is known to be arriving. */
                 AsynchronousStream* const stream_ = addressof(stream);
-                boost::asio::async_read(*stream_, boost::asio::buffer(buffer_.get(), ETRANSMISSION_TSS),
+                boost::asio::async_read(*stream_, boost::asio::buffer(header_, ETRANSMISSION_TSS),
                     [reference_, this, callback_, stream_](const boost::system::error_code& ec, std::size_t sz) noexcept {
                         int length = std::max<int>(-1, ec ? -1 : sz);
                         if (length < 1) {
@@ -77,36 +124,49 @@ namespace uds {
                             return;
                         }
 
-                        Byte* p = buffer_.get();
+                        Byte* p = header_;
                         length = p[0] << 8 | p[1];
                         if (length < 1 || length > ETRANSMISSION_MSS) {
                             trigger(this, -1, callback_);
                             return;
                         }
 
-                        boost::asio::async_read(*stream_, boost::asio::buffer(buffer_.get(), length),
-                            [reference_, this, callback_](const boost::system::error_code& ec, std::size_t sz) noexcept {
+                        const std::shared_ptr<Byte> buffers = uds::threading::Hosting::RentBuffer();
+                        if (!buffers) {
+                            trigger(this, -1, callback_);
+                            return;
+                        }
+
+                        boost::asio::async_read(*stream_, boost::asio::buffer(buffers.get(), length),
+                            [reference_, this, callback_, buffers](const boost::system::error_code& ec, std::size_t sz) noexcept {
                                 int length = std::max<int>(-1, ec ? -1 : sz);
                                 if (length < 1) {
                                     trigger(this, length, callback_);
                                     return;
                                 }
 
-                                callback_(buffer_, length);
+                                callback_(buffers, length);
                             });
                     });
                 return true;
             }
-            pmessage                                                Pack(const void* buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept;
+            void                                                    Pack(message& messages, const std::shared_ptr<Byte>& buffer, int offset, int length, const Byte* trailer, int trailer_size, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept;
 
         private:
             std::atomic<bool>                                       disposed_;
             std::shared_ptr<uds::threading::Hosting>                hosting_;
-            std::shared_ptr<Byte>                                   buffer_;
+            Byte                                                    header_[2];
             std::shared_ptr<boost::asio::io_context>                context_;
             std::shared_ptr<boost::asio::ip::tcp::socket>           socket_;
             std::atomic<bool>                                       writing_;
+            int                                                     coalescing_;
+            std::atomic<int>                                        queue_high_water_;
+            message                                                 ring_[ETRANSMISSION_RING];
+            int                                                     ring_head_;
+            int                                                     ring_count_;
+            int                                                     batch_count_;
             message_queue                                           messages_;
+            std::vector<boost::asio::const_buffer>                  batch_buffers_;
             uds::net::IPEndPoint                                    localEP_;
             uds::net::IPEndPoint                                    remoteEP_;
         };
@@ -178,22 +178,11 @@ namespace uds {
             return url_;
         }
 
-        bool WebSocketTransmission::OnWriteAsync(const BOOST_ASIO_MOVE_ARG(pmessage) message) noexcept {
+        bool WebSocketTransmission::OnWriteAsync(const message_buffers& buffers) noexcept {
             const std::shared_ptr<ITransmission> reference = GetReference();
-            const pmessage messages = BOOST_ASIO_MOVE_CAST(pmessage)(constantof(message));
-
-            websocket_.async_write(boost::asio::buffer(messages->packet.get(), messages->packet_size),
-                [reference, this, messages](const boost::system::error_code& ec, size_t sz) noexcept {
-                    bool success = ec ? false :true;
-                    if (!success) {
-                        Close();
-                    }
-
-                    const WriteAsyncCallback& callback = messages->callback;
-                    if (callback) {
-                        callback(success);
-                    }
-                    OnAsyncWrite(true);
+            websocket_.async_write(buffers,
+                [reference, this](const boost::system::error_code& ec, size_t sz) noexcept {
+                    OnWriteCompleted(ec ? false : true);
                 });
             return true;
         }
@@ -221,13 +210,7 @@ namespace uds {
                 return false;
             }
 
-            pmessage messages = Pack(buffer.get(), offset, length, forward0f(callback));
-            if (!messages) {
-                return false;
-            }
-
-            OnAddWriteAsync(forward0f(messages));
-            return true;
+            return OnAddWriteAsync(buffer, offset, length, forward0f(callback));
         }
     }
 }
\ No newline at end of file
@@ -22,6 +22,9 @@ namespace uds {
             virtual bool                                                HandshakeAsync(HandshakeType type, const BOOST_ASIO_MOVE_ARG(HandshakeAsyncCallback) callback) noexcept override;
             virtual bool                                                WriteAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept override;
             virtual bool                                                ReadAsync(const BOOST_ASIO_MOVE_ARG(ReadAsyncCallback) callback) noexcept override;
+            inline virtual bool                                         Relocate(const std::shared_ptr<boost::asio::io_context>& context) noexcept override {
+                return context == GetContext();
+            }
 
         public:
             static std::string                                          WSSOF(
@@ -33,7 +36,7 @@ namespace uds {
                 bool&                                                   tlsv) noexcept;
 
         protected:
-            virtual bool                                                OnWriteAsync(const BOOST_ASIO_MOVE_ARG(pmessage) message) noexcept override;
+            virtual bool                                                OnWriteAsync(const message_buffers& buffers) noexcept override;
 
         private:
             std::atomic<bool>                                           disposed_;
@@ -24,7 +24,8 @@ namespace uds {
                     std::string&                                    certificate_key_file,
                     std::string&                                    certificate_chain_file,
                     std::string&                                    certificate_key_password,
-                    std::string&                                    ciphersuites) noexcept 
+                    std::string&                                    ciphersuites,
+                    uds::ssl::SslOptions&                           options) noexcept 
                     : tcp_socket_(tcp_socket)
                     , ssl_context_(ssl_context)
                     , ssl_socket_(ssl_socket)
@@ -34,7 +35,8 @@ namespace uds {
                     , certificate_key_file_(certificate_key_file)
                     , certificate_chain_file_(certificate_chain_file)
                     , certificate_key_password_(certificate_key_password)
-                    , ciphersuites_(ciphersuites) {
+                    , ciphersuites_(ciphersuites)
+                    , options_(options) {
                     
                 }
 
@@ -59,13 +61,13 @@ namespace uds {
                     }
 
                     if (type == HandshakeType::HandshakeType_Client) {
-                        ssl_context_ = uds::ssl::SSL::CreateClientSslContext(uds::ssl::SSL::SSL_METHOD::tlsv13, verify_peer_, ciphersuites_);
+                        ssl_context_ = uds::ssl::SSL::GetClientSslContext(uds::ssl::SSL::SSL_METHOD::tls, verify_peer_, ciphersuites_, options_);
                     }
                     elif(certificate_file_.empty() || certificate_key_file_.empty() || certificate_chain_file_.empty()) {
                         return false;
                     }
                     else {
-                        ssl_context_ = uds::ssl::SSL::CreateServerSslContext(uds::ssl::SSL::SSL_METHOD::tlsv13, certificate_file_, certificate_key_file_, certificate_chain_file_, certificate_key_password_, ciphersuites_);
+                        ssl_context_ = uds::ssl::SSL::GetServerSslContext(uds::ssl::SSL::SSL_METHOD::tls, certificate_file_, certificate_key_file_, certificate_chain_file_, certificate_key_password_, ciphersuites_, options_);
                     }
 
                     boost::system::error_code ec;
@@ -85,6 +87,11 @@ namespace uds {
                         }
                     }
 
+                    // Resume with a ticket from an earlier leg when there is one.
+                    if (type == HandshakeType::HandshakeType_Client) {
+                        uds::ssl::SSL::ResumeSslSession(GetSslHandle());
+                    }
+
                     return PerformSslHandshakeAsync(type, forward0f(callback));
                 }
 
@@ -106,6 +113,7 @@ namespace uds {
                 std::string&                                        certificate_chain_file_;
                 std::string&                                        certificate_key_password_;
                 std::string&                                        ciphersuites_;
+                uds::ssl::SslOptions&                               options_;
             };
         }
     }
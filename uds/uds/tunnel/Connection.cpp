@@ -1,6 +1,9 @@
 #include <uds/threading/Timer.h>
 #include <uds/net/Ipep.h>
 #include <uds/tunnel/Connection.h>
+#include <uds/tunnel/Multiplexer.h>
+#include <uds/transmission/Transmission.h>
+#include <openssl/rand.h>
 
 namespace uds {
     namespace tunnel {
@@ -10,23 +13,32 @@ namespace uds {
             , available_(false)
             , configuration_(configuration)
             , inbound_(inbound)
-            , outbound_(outbound) {
+            , outbound_(outbound)
+            , remote_writing_(false) {
+            if (inbound) {
+                context_ = inbound->GetContext();
+            }
+
             if (configuration) {
                 int alignment = configuration->Alignment;
                 if (alignment >= (UINT8_MAX << 1) && alignment <= ECONNECTION_MSS) {
                     constantof(ECONNECTION_MSS) = alignment;
                 }
+
+                /* A multiplexed segment must still fit one leg message together with its frame header. */
+                if (configuration->Multiplex.Enabled) {
+                    constantof(ECONNECTION_MSS) -= Multiplexer::MULTIPLEX_HEADER;
+                }
             }
         }
 
         bool Connection::Listen(const AsyncTcpSocketPtr& network) noexcept {
             typedef uds::net::Ipep Ipep;
 
-            if (disposed_ || buffers_) {
+            if (disposed_ || remote_ || resolver_) {
                 return false;
             }
 
-            buffers_ = make_shared_alloc<Byte>(ECONNECTION_MSS);
             if (network) {
                 remote_ = network;
                 available_ = EstablishRemoteSocket();
@@ -63,15 +75,61 @@ namespace uds {
         }
 
         bool Connection::EstablishRemoteSocket() noexcept {
-            bool available = InboundSocketToRemoteSocket() && RemoteSocketToOutboundSocket();
+            /* The remote socket is drained with non-blocking reads once it signals readable. */
+            boost::system::error_code ec;
+            remote_->non_blocking(true, ec);
+            if (ec) {
+                return false;
+            }
+
+            /* Streams of a multiplexer share the legs, those are spliced by nobody and kept alive by the multiplexer. */
+            bool multiplexed = configuration_->Multiplex.Enabled;
+            bool available = false;
+            if (configuration_->Splice && !multiplexed && configuration_->Protocol == AppConfiguration::ProtocolType_TCP && SpliceRelay::IsSupported()) {
+                available = SpliceRemoteSocket();
+            }
+            else {
+                available = InboundSocketToRemoteSocket() && RemoteSocketToOutboundSocket();
+            }
+
             if (available) {
-                if (configuration_->KeepAlived) {
+                if (configuration_->KeepAlived && !multiplexed) {
                     available = KeepAlivedReadCycle(outbound_) && KeepAlivedSendCycle(inbound_);
                 }
             }
             return available;
         }
 
+        bool Connection::SpliceRemoteSocket() noexcept {
+            typedef uds::transmission::Transmission Transmission;
+
+            const std::shared_ptr<Transmission> inbound = AsReference<Transmission>(inbound_);
+            const std::shared_ptr<Transmission> outbound = AsReference<Transmission>(outbound_);
+            if (!inbound || !outbound) {
+                return false;
+            }
+
+            /* The relays drive the raw sockets of the legs, so the legs must share the context of the remote socket. */
+            const AsyncContextPtr context = GetContext();
+            if (inbound->GetContext() != context || outbound->GetContext() != context) {
+                return InboundSocketToRemoteSocket() && RemoteSocketToOutboundSocket();
+            }
+
+            inbound_relay_ = NewReference<SpliceRelay>(inbound->GetSocket(), remote_, SpliceRelay::FramingMode_Unpack, uds::threading::Hosting::BufferSize);
+            outbound_relay_ = NewReference<SpliceRelay>(remote_, outbound->GetSocket(), SpliceRelay::FramingMode_Pack, ECONNECTION_MSS);
+            if (!inbound_relay_ || !outbound_relay_) {
+                return false;
+            }
+
+            const std::shared_ptr<Reference> references = GetReference();
+            inbound_relay_->ClosedEvent =
+                [references, this](SpliceRelay*) noexcept {
+                    Close();
+                };
+            outbound_relay_->ClosedEvent = inbound_relay_->ClosedEvent;
+            return inbound_relay_->Run() && outbound_relay_->Run();
+        }
+
         bool Connection::ConnectRemoteSocket(boost::asio::ip::tcp::endpoint remoteEP) noexcept {
             const AsyncTcpSocketPtr socket = NewRemoteSocket(configuration_, GetContext(), remoteEP);
             if (!socket) {
@@ -94,16 +152,7 @@ namespace uds {
         }
 
         Connection::AsyncContextPtr Connection::GetContext() noexcept {
-            const ITransmissionPtr inbound = inbound_;
-            if (inbound) {
-                return inbound->GetContext();
-            }
-
-            const ITransmissionPtr outbound = outbound_;
-            if (outbound) {
-                return outbound->GetContext();
-            }
-            return NULL;
+            return context_;
         }
 
         Connection::AsyncTcpSocketPtr Connection::NewRemoteSocket(const AppConfigurationPtr& configuration, const AsyncContextPtr& context) noexcept {
@@ -174,7 +223,7 @@ namespace uds {
         }
 
         bool Connection::IsDisposed() noexcept {
-            return IsNone() || !remote_ || !buffers_;
+            return IsNone() || !remote_;
         }
 
         bool Connection::Available() noexcept {
@@ -182,7 +231,18 @@ namespace uds {
         }
 
         void Connection::Close() noexcept {
-            Dispose();
+            const AsyncContextPtr context = GetContext();
+            if (!context) {
+                Dispose();
+                return;
+            }
+
+            /* The connection is owned by the worker context of its inbound transmission. */
+            const std::shared_ptr<Reference> references = GetReference();
+            boost::asio::dispatch(*context,
+                [references, this]() noexcept {
+                    Dispose();
+                });
         }
 
         void Connection::Dispose() noexcept {
@@ -194,7 +254,23 @@ namespace uds {
 
                 const ITransmissionPtr outbound = std::move(outbound_);
                 if (outbound) {
-                    outbound->Close();
+                    const AsyncContextPtr context = outbound->GetContext();
+                    if (context) {
+                        boost::asio::dispatch(*context,
+                            [outbound]() noexcept {
+                                outbound->Close();
+                            });
+                    }
+                    else {
+                        outbound->Close();
+                    }
+                }
+
+                const SpliceRelayPtr relays[] = { std::move(inbound_relay_), std::move(outbound_relay_) };
+                for (const SpliceRelayPtr& relay : relays) {
+                    if (relay) {
+                        relay->Close();
+                    }
                 }
 
                 const AsyncTcpSocketPtr remote = std::move(remote_);
@@ -210,8 +286,8 @@ namespace uds {
                     catch (std::exception&) {}
                 }
 
-                buffers_.reset();
                 remote_.reset();
+                remote_segments_.clear();
                 inbound_.reset();
                 outbound_.reset();
                 resolver_.reset();
@@ -235,22 +311,49 @@ namespace uds {
                 return false;
             }
 
-            const std::shared_ptr<Byte> buffers = buffers_;
-            if (!buffers) {
-                return false;
+            /* Reads run ahead of the outbound writes until the pipeline window is full. */
+            if (outbound_window_.reading || !IsWindowOpen(outbound_window_)) {
+                return true;
             }
 
+            /* Wait for readability first so that an idle tunnel does not pin a relay buffer. */
             const std::shared_ptr<Reference> references = GetReference();
-            socket->async_read_some(boost::asio::buffer(buffers.get(), ECONNECTION_MSS),
-                [references, this, socket, buffers](const boost::system::error_code& ec, size_t sz) noexcept {
-                    int length = std::max<int>(ec ? -1 : sz, -1);
-                    if (!SendToOutboundSocket(buffers.get(), length)) {
+            outbound_window_.reading = true;
+            socket->async_wait(AsyncTcpSocket::wait_read,
+                [references, this, socket](const boost::system::error_code& ec) noexcept {
+                    outbound_window_.reading = false;
+                    if (ec) {
+                        Close();
+                        return;
+                    }
+
+                    const std::shared_ptr<Byte> buffers = uds::threading::Hosting::RentBuffer();
+                    if (!buffers) {
+                        Close();
+                        return;
+                    }
+
+                    boost::system::error_code ec_;
+                    size_t sz = socket->read_some(boost::asio::buffer(buffers.get(), ECONNECTION_MSS), ec_);
+                    if (ec_ == boost::asio::error::would_block || ec_ == boost::asio::error::try_again) {
+                        if (!RemoteSocketToOutboundSocket()) {
+                            Close();
+                        }
+                        return;
+                    }
+
+                    int length = std::max<int>(ec_ ? -1 : sz, -1);
+                    if (!SendToOutboundSocket(buffers, length) || !RemoteSocketToOutboundSocket()) {
                         Close();
                     }
                 });
             return true;
         }
 
+        bool Connection::IsWindowOpen(const PipelineWindow& window) noexcept {
+            return window.segments < configuration_->Pipeline.Segments && window.bytes < configuration_->Pipeline.Window;
+        }
+
         bool Connection::InboundSocketToRemoteSocket() noexcept {
             if (disposed_) {
                 return false;
@@ -261,37 +364,74 @@ namespace uds {
                 return false;
             }
 
+            if (inbound_window_.reading || !IsWindowOpen(inbound_window_)) {
+                return true;
+            }
+
             const std::shared_ptr<Reference> references = GetReference();
+            inbound_window_.reading = true;
             return socket->ReadAsync(
                 [references, this, socket](const std::shared_ptr<Byte>& buffers, int length) noexcept {
-                    if (!SendToRemoteSocket(buffers.get(), length)) {
+                    inbound_window_.reading = false;
+                    if (!SendToRemoteSocket(buffers, length) || !InboundSocketToRemoteSocket()) {
                         Close();
                     }
                 });
         }
 
-        bool Connection::SendToRemoteSocket(const void* buffer, int length) noexcept {
+        bool Connection::SendToRemoteSocket(const std::shared_ptr<Byte>& buffer, int length) noexcept {
             if (disposed_ || !buffer || length < 1) {
                 return false;
             }
 
+            if (!remote_) {
+                return false;
+            }
+
+            /* Segments are written to the remote socket one at a time and in the order they were read. */
+            remote_segments_.push_back(RemoteSegment(buffer, length));
+            inbound_window_.segments++;
+            inbound_window_.bytes += length;
+            if (remote_writing_) {
+                return true;
+            }
+            return FlushRemoteSocket();
+        }
+
+        bool Connection::FlushRemoteSocket() noexcept {
             const AsyncTcpSocketPtr socket = remote_;
             if (!socket) {
                 return false;
             }
 
+            if (remote_segments_.empty()) {
+                remote_writing_ = false;
+                return true;
+            }
+
+            /* The rented buffer goes back to the pool once the write completes. */
             const std::shared_ptr<Reference> references = GetReference();
-            boost::asio::async_write(*socket, boost::asio::buffer(buffer, length),
-                [references, this, socket](const boost::system::error_code& ec, size_t sz) noexcept {
-                    int length = std::max<int>(ec ? -1 : sz, -1);
-                    if (length < 1 || !InboundSocketToRemoteSocket()) {
+            const std::shared_ptr<Byte> buffers = remote_segments_.front().first;
+            const int length = remote_segments_.front().second;
+
+            remote_writing_ = true;
+            boost::asio::async_write(*socket, boost::asio::buffer(buffers.get(), length),
+                [references, this, socket, buffers, length](const boost::system::error_code& ec, size_t sz) noexcept {
+                    if (disposed_) {
+                        return;
+                    }
+
+                    remote_segments_.pop_front();
+                    inbound_window_.segments--;
+                    inbound_window_.bytes -= length;
+                    if (ec || !FlushRemoteSocket() || !InboundSocketToRemoteSocket()) {
                         Close();
                     }
                 });
             return true;
         }
 
-        bool Connection::SendToOutboundSocket(const void* buffer, int length) noexcept {
+        bool Connection::SendToOutboundSocket(const std::shared_ptr<Byte>& buffer, int length) noexcept {
             if (disposed_ || !buffer || length < 1) {
                 return false;
             }
@@ -301,13 +441,35 @@ namespace uds {
                 return false;
             }
 
+            const AsyncContextPtr owner = GetContext();
+            const AsyncContextPtr context = socket->GetContext();
+            if (!owner || !context) {
+                return false;
+            }
+
+            /* The outbound transmission may live on another worker context than this connection. */
             const std::shared_ptr<Reference> references = GetReference();
-            return socket->WriteAsync(std::shared_ptr<Byte>((Byte*)buffer, [](const void*) noexcept {}), 0, length,
-                [references, this, socket](bool success) noexcept {
-                    if (!success || !RemoteSocketToOutboundSocket()) {
+            const std::shared_ptr<Byte> buffers = buffer;
+            outbound_window_.segments++;
+            outbound_window_.bytes += length;
+            boost::asio::dispatch(*context,
+                [references, this, socket, owner, buffers, length]() noexcept {
+                    bool success = socket->WriteAsync(buffers, 0, length,
+                        [references, this, owner, buffers, length](bool success) noexcept {
+                            boost::asio::dispatch(*owner,
+                                [references, this, success, length]() noexcept {
+                                    outbound_window_.segments--;
+                                    outbound_window_.bytes -= length;
+                                    if (!success || !RemoteSocketToOutboundSocket()) {
+                                        Close();
+                                    }
+                                });
+                        });
+                    if (!success) {
                         Close();
                     }
                 });
+            return true;
         }
 
         bool Connection::HandshakeServer(const ITransmissionPtr& transmission, int alignment, int channelId, AcceptAsyncCallback&& handler) noexcept {
@@ -384,25 +546,82 @@ namespace uds {
             return HandshakeClient(inbound, std::forward<ConnectAsyncCallback>(handler));
         }
 
+        Int64 Connection::NewProposalToken() noexcept {
+            /* The token alone pairs the two legs on the server, it is drawn from the OpenSSL generator so that peers cannot guess it. */
+            for (;;) {
+                Int64 token = 0;
+                if (RAND_bytes((Byte*)&token, sizeof(token)) < 1) {
+                    return 0;
+                }
+                elif((int)token && (int)(token >> 32)) {
+                    return token;
+                }
+            }
+        }
+
+        bool Connection::ProposeAsync(const ITransmissionPtr& transmission, int alignment, Int64 token, ProposeAsyncCallback&& handler) noexcept {
+            if (!transmission || !handler || alignment < (UINT8_MAX << 1) || !(int)token || !(int)(token >> 32)) {
+                return false;
+            }
+
+            /* The low half takes the place of the channel id, the high half follows it. */
+            MemoryStream messages;
+            UInt32 proposal = (UInt32)(token >> 32);
+            if (!PackPlaintextHeaders(messages, (int)token, &proposal, alignment)) {
+                return false;
+            }
+
+            const ProposeAsyncCallback callback = std::move(handler);
+            const ITransmissionPtr ctransmission = transmission;
+            return ctransmission->WriteAsync(messages.GetBuffer(), 0, messages.GetPosition(),
+                [ctransmission, callback](bool success) noexcept {
+                    callback(success);
+                });
+        }
+
+        bool Connection::AcceptProposalAsync(const ITransmissionPtr& transmission, AcceptProposalAsyncCallback&& handler) noexcept {
+            if (!transmission || !handler) {
+                return false;
+            }
+
+            const AcceptProposalAsyncCallback callback = std::move(handler);
+            const ITransmissionPtr ctransmission = transmission;
+            return ctransmission->ReadAsync(
+                [ctransmission, callback](const std::shared_ptr<Byte>& buffer, int length) noexcept {
+                    Int64 token = 0;
+                    if (buffer && length > 0) {
+                        token = UnpackProposalToken(buffer.get(), length);
+                    }
+                    callback(token != 0, token);
+                });
+        }
+
         bool Connection::PackPlaintextHeaders(Stream& stream, int channelId, int alignment) noexcept {
+            return PackPlaintextHeaders(stream, channelId, NULL, alignment);
+        }
+
+        bool Connection::PackPlaintextHeaders(Stream& stream, int channelId, const UInt32* proposal, int alignment) noexcept {
             if (!stream.CanWrite()) {
                 return false;
             }
 
             Char messages[uds::threading::Hosting::BufferSize];
             int messages_size = RandomNext(UINT8_MAX << 1, std::min<int>(alignment, sizeof(messages)));
-            for (int i = 0; i < messages_size; i++) {
-                messages[i] = RandomAscii();
-            }
+            RandomAscii(messages, messages_size);
 
-            int offset = sprintf((char*)messages + 1, "%04X%08X", messages_size, channelId ^ (messages_size << 16 | messages_size));
+            int mask = messages_size << 16 | messages_size;
+            int offset = proposal ?
+                sprintf((char*)messages + 1, "%04X%08X%08X", messages_size, channelId ^ mask, *proposal ^ (UInt32)mask) :
+                sprintf((char*)messages + 1, "%04X%08X", messages_size, channelId ^ mask);
             if (offset < 1) {
                 return false;
             }
 
+            /* One bit of a single draw per header character picks its case. */
+            uint64_t cases = RandomNextUInt64();
             for (int i = 0; i < offset; i++) {
                 Char& ch = messages[1 + i];
-                ch = RandomNext(0, 1) ? tolower(ch) : toupper(ch);
+                ch = (cases >> i) & 1 ? tolower(ch) : toupper(ch);
             }
             messages[1 + offset] = RandomAscii();
             return stream.Write(messages, 0, messages_size);
@@ -418,16 +637,16 @@ namespace uds {
                 return 0;
             }
 
-            char len[4];
-            memcpy(len, data + 1, sizeof(len));
+            char len[5] = { 0 };
+            memcpy(len, data + 1, 4);
 
             Int64 messages_size = strtoll(len, NULL, 16);
             if (13 >= messages_size) {
                 return 0;
             }
 
-            char id[8];
-            memcpy(id, data + 5, sizeof(id));
+            char id[9] = { 0 };
+            memcpy(id, data + 5, 8);
 
             Int64 channelid = strtoll(id, NULL, 16);
             channelid ^= messages_size << 16 | messages_size;
@@ -435,22 +654,53 @@ namespace uds {
             return channelid << 32 | messages_size;
         }
 
+        Int64 Connection::UnpackProposalToken(const void* buffer, int length) noexcept {
+            if (21 > length) {
+                return 0;
+            }
+
+            Int64 v = UnpackPlaintextLength(buffer, 0, length);
+            int messages_size = (int)(v);
+            if (!v || messages_size != length) {
+                return 0;
+            }
+
+            char proposal[9] = { 0 };
+            memcpy(proposal, (char*)buffer + 13, 8);
+
+            UInt32 high = (UInt32)strtoll(proposal, NULL, 16) ^ (UInt32)(messages_size << 16 | messages_size);
+            UInt32 low = (UInt32)(v >> 32);
+            if (!high || !low) {
+                return 0;
+            }
+            return (Int64)((UInt64)high << 32 | low);
+        }
+
         bool Connection::KeepAlivedReadCycle(const ITransmissionPtr& transmission) noexcept {
             if (disposed_ || !transmission) {
                 return false;
             }
 
+            const AsyncContextPtr context = transmission->GetContext();
+            if (!context) {
+                return false;
+            }
+
             const std::shared_ptr<Reference> references = GetReference();
             const ITransmissionPtr network = transmission;
-            return network->ReadAsync(
-                [network, references, this](const std::shared_ptr<Byte>& buffers, int length) noexcept {
-                    if (length < 1) {
+            boost::asio::dispatch(*context,
+                [network, references, this]() noexcept {
+                    bool success = network->ReadAsync(
+                        [network, references, this](const std::shared_ptr<Byte>& buffers, int length) noexcept {
+                            if (length < 1 || !KeepAlivedReadCycle(network)) {
+                                Close();
+                            }
+                        });
+                    if (!success) {
                         Close();
                     }
-                    else {
-                        KeepAlivedReadCycle(network);
-                    }
                 });
+            return true;
         }
 
         bool Connection::KeepAlivedSendCycle(const ITransmissionPtr& transmission) noexcept {
@@ -483,9 +733,7 @@ namespace uds {
 
                     Byte* packet = messages.get();
                     int packet_size = RandomNext(8, 64);
-                    for (int i = 0; i < packet_size; i++) {
-                        packet[i] = RandomAscii();
-                    }
+                    RandomAscii((Char*)packet, packet_size);
 
                     if (!network->WriteAsync(messages, 0, packet_size,
                         [references, this, network](bool success) noexcept {
@@ -8,6 +8,7 @@
 #include <uds/net/Socket.h>
 #include <uds/net/IPEndPoint.h>
 #include <uds/transmission/ITransmission.h>
+#include <uds/tunnel/SpliceRelay.h>
 #include <uds/configuration/AppConfiguration.h>
 
 namespace uds {
@@ -28,12 +29,15 @@ namespace uds {
             using Stream                        = uds::io::Stream;
             using BinaryReader                  = uds::io::BinaryReader;
             using MemoryStream                  = uds::io::MemoryStream;
+            using SpliceRelayPtr                = std::shared_ptr<SpliceRelay>;
 
         public:
             using DisposedEventHandler          = std::function<void(Connection*)>;
             using AcceptAsyncCallback           = std::function<void(bool, int)>;
             using AcceptAsyncMeasureChannelId   = std::function<int(const ITransmissionPtr&)>;
             using ConnectAsyncCallback          = AcceptAsyncCallback;
+            using ProposeAsyncCallback          = std::function<void(bool)>;
+            using AcceptProposalAsyncCallback   = std::function<void(bool, Int64)>;
 
         public:
             const int                           ECONNECTION_MSS = uds::threading::Hosting::BufferSize;
@@ -55,9 +59,17 @@ namespace uds {
             static bool                         ConnectAsync(const ITransmissionPtr& outbound, int alignment, int channelId, ConnectAsyncCallback&& handler) noexcept;
             static bool                         ConnectAsync(const ITransmissionPtr& inbound, ConnectAsyncCallback&& handler) noexcept;
 
+        public:
+            /* Client proposed channels: the client writes one token on both legs at once, the server pairs the legs by it and answers nothing. */
+            static Int64                        NewProposalToken() noexcept;
+            static bool                         ProposeAsync(const ITransmissionPtr& transmission, int alignment, Int64 token, ProposeAsyncCallback&& handler) noexcept;
+            static bool                         AcceptProposalAsync(const ITransmissionPtr& transmission, AcceptProposalAsyncCallback&& handler) noexcept;
+
         private:
             static bool                         PackPlaintextHeaders(Stream& stream, int channelId, int alignment) noexcept;
+            static bool                         PackPlaintextHeaders(Stream& stream, int channelId, const UInt32* proposal, int alignment) noexcept;
             static Int64                        UnpackPlaintextLength(const void* buffer, int offset, int length) noexcept;
+            static Int64                        UnpackProposalToken(const void* buffer, int length) noexcept;
             static bool                         HandshakeClient(const ITransmissionPtr& transmission, ConnectAsyncCallback&& handler) noexcept;
             static bool                         HandshakeServer(const ITransmissionPtr& transmission, int alignment, int channelId, AcceptAsyncCallback&& handler) noexcept;
 
@@ -72,6 +84,7 @@ namespace uds {
 
         private:
             bool                                EstablishRemoteSocket() noexcept;
+            bool                                SpliceRemoteSocket() noexcept;
             bool                                KeepAlivedReadCycle(const ITransmissionPtr& transmission) noexcept;
             bool                                KeepAlivedSendCycle(const ITransmissionPtr& transmission) noexcept;
             bool                                ConnectRemoteSocket(boost::asio::ip::tcp::endpoint remoteEP) noexcept;
@@ -81,8 +94,19 @@ namespace uds {
             bool                                InboundSocketToRemoteSocket() noexcept;
 
         private:
-            bool                                SendToRemoteSocket(const void* buffer, int length) noexcept;
-            bool                                SendToOutboundSocket(const void* buffer, int length) noexcept;
+            bool                                SendToRemoteSocket(const std::shared_ptr<Byte>& buffer, int length) noexcept;
+            bool                                SendToOutboundSocket(const std::shared_ptr<Byte>& buffer, int length) noexcept;
+            bool                                FlushRemoteSocket() noexcept;
+
+        private:
+            /* Segments read from one side and not yet written to the other. */
+            struct PipelineWindow {
+                int                             segments = 0;
+                int                             bytes = 0;
+                bool                            reading = false;
+            };
+            using RemoteSegment                 = std::pair<std::shared_ptr<Byte>, int>;
+            bool                                IsWindowOpen(const PipelineWindow& window) noexcept;
 
         private:
             std::atomic<bool>                   disposed_;
@@ -90,10 +114,16 @@ namespace uds {
             ITransmissionPtr                    inbound_;
             ITransmissionPtr                    outbound_;
             AppConfigurationPtr                 configuration_;
+            AsyncContextPtr                     context_;
             AsyncTcpSocketPtr                   remote_;
             AsyncResolverPtr                    resolver_;
             AsyncDeadlineTimerPtr               timeout_;
-            std::shared_ptr<Byte>               buffers_;
+            PipelineWindow                      inbound_window_;
+            PipelineWindow                      outbound_window_;
+            bool                                remote_writing_;
+            std::deque<RemoteSegment>           remote_segments_;
+            SpliceRelayPtr                      inbound_relay_;
+            SpliceRelayPtr                      outbound_relay_;
         };
     }
 }
\ No newline at end of file
@@ -0,0 +1,258 @@
+#include <uds/tunnel/MultiplexStream.h>
+
+namespace uds {
+    namespace tunnel {
+        MultiplexStream::MultiplexStream(const std::shared_ptr<Multiplexer>& multiplexer, int id) noexcept
+            : Id(id)
+            , disposed_(false)
+            , remote_closed_(false)
+            , multiplexer_(multiplexer)
+            , window_(Multiplexer::MULTIPLEX_WINDOW)
+            , consumed_(0)
+            , credit_(Multiplexer::MULTIPLEX_WINDOW) {
+            if (multiplexer) {
+                context_ = multiplexer->GetContext();
+
+                const Multiplexer::ITransmissionPtr& inbound = multiplexer->inbound_;
+                if (inbound) {
+                    localEP_ = inbound->GetLocalEndPoint();
+                    remoteEP_ = inbound->GetRemoteEndPoint();
+                }
+            }
+        }
+
+        int MultiplexStream::GetMaxSegmentSize() noexcept {
+            const std::shared_ptr<Multiplexer> multiplexer = multiplexer_;
+            return multiplexer ? multiplexer->payload_size_ : 0;
+        }
+
+        std::shared_ptr<boost::asio::io_context> MultiplexStream::GetContext() noexcept {
+            return context_;
+        }
+
+        uds::net::IPEndPoint MultiplexStream::GetLocalEndPoint() noexcept {
+            return localEP_;
+        }
+
+        uds::net::IPEndPoint MultiplexStream::GetRemoteEndPoint() noexcept {
+            return remoteEP_;
+        }
+
+        bool MultiplexStream::HandshakeAsync(HandshakeType, const BOOST_ASIO_MOVE_ARG(HandshakeAsyncCallback) callback) noexcept {
+            if (disposed_ || !context_ || !callback) {
+                return false;
+            }
+
+            /* The leg pair is already through its handshake. */
+            const std::shared_ptr<ITransmission> reference_ = GetReference();
+            const HandshakeAsyncCallback callback_ = BOOST_ASIO_MOVE_CAST(HandshakeAsyncCallback)(constantof(callback));
+            boost::asio::post(*context_,
+                [reference_, this, callback_]() noexcept {
+                    callback_(!disposed_);
+                });
+            return true;
+        }
+
+        bool MultiplexStream::Relocate(const std::shared_ptr<boost::asio::io_context>& context) noexcept {
+            return context && context == context_;
+        }
+
+        bool MultiplexStream::Listen() noexcept {
+            const std::shared_ptr<Multiplexer> multiplexer = multiplexer_;
+            if (disposed_ || !multiplexer) {
+                return false;
+            }
+
+            /* Every stream starts out with the same credit, the configured window is granted on top of it. */
+            int increment = multiplexer->window_size_ - window_;
+            if (increment < 1) {
+                return true;
+            }
+
+            window_ += increment;
+            return multiplexer->SendControl(Multiplexer::FrameType_Window, Id, increment);
+        }
+
+        void MultiplexStream::Dispose() noexcept {
+            if (!disposed_.exchange(true)) {
+                ReadAsyncCallback reading = std::move(reading_);
+                reading_ = NULL;
+                read_segments_.clear();
+                write_segments_.clear();
+
+                /* The peer hears of it unless it closed the stream first. */
+                const std::shared_ptr<Multiplexer> multiplexer = std::move(multiplexer_);
+                if (multiplexer) {
+                    multiplexer_.reset();
+                    multiplexer->CloseStream(Id, !remote_closed_);
+                }
+
+                if (reading) {
+                    reading(NULL, -1);
+                }
+            }
+        }
+
+        bool MultiplexStream::ReadAsync(const BOOST_ASIO_MOVE_ARG(ReadAsyncCallback) callback) noexcept {
+            if (disposed_ || !callback || reading_) {
+                return false;
+            }
+
+            if (read_segments_.empty()) {
+                if (remote_closed_) {
+                    return false;
+                }
+
+                reading_ = BOOST_ASIO_MOVE_CAST(ReadAsyncCallback)(constantof(callback));
+                return true;
+            }
+
+            /* Completes like a socket read would, never from inside the call. */
+            const std::shared_ptr<ITransmission> reference_ = GetReference();
+            const ReadAsyncCallback callback_ = BOOST_ASIO_MOVE_CAST(ReadAsyncCallback)(constantof(callback));
+            const ReadSegment segment = std::move(read_segments_.front());
+            read_segments_.pop_front();
+
+            boost::asio::post(*context_,
+                [reference_, this, callback_, segment]() noexcept {
+                    if (!Acknowledge(segment.second)) {
+                        Close();
+                    }
+                    callback_(segment.first, segment.second);
+                });
+            return true;
+        }
+
+        bool MultiplexStream::WriteAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept {
+            if (disposed_ || !buffer || offset < 0 || length < 1) {
+                return false;
+            }
+
+            write_segments_.emplace_back();
+            WriteSegment& segment = write_segments_.back();
+            segment.buffer = buffer;
+            segment.offset = offset;
+            segment.length = length;
+            segment.callback = BOOST_ASIO_MOVE_CAST(WriteAsyncCallback)(constantof(callback));
+            return Flush();
+        }
+
+        bool MultiplexStream::Flush() noexcept {
+            const std::shared_ptr<Multiplexer> multiplexer = multiplexer_;
+            if (disposed_ || !multiplexer) {
+                return false;
+            }
+
+            /* Sends what the credit covers, the rest waits for the next window frame of the peer. */
+            while (!write_segments_.empty() && credit_ > 0) {
+                const std::shared_ptr<Byte> packet = uds::threading::Hosting::RentBuffer();
+                if (!packet) {
+                    return false;
+                }
+
+                WriteSegment& segment = write_segments_.front();
+                int length = std::min<int>(std::min<int>(segment.length, credit_), multiplexer->payload_size_);
+                memcpy(packet.get() + Multiplexer::MULTIPLEX_HEADER, segment.buffer.get() + segment.offset, length);
+
+                segment.offset += length;
+                segment.length -= length;
+                credit_ -= length;
+
+                /* Only the frame that finishes a write reports back. */
+                WriteAsyncCallback callback;
+                if (!segment.length) {
+                    callback = std::move(segment.callback);
+                    write_segments_.pop_front();
+                }
+
+                if (!multiplexer->SendFrame(Multiplexer::FrameType_Data, Id, packet, length, std::move(callback))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool MultiplexStream::Acknowledge(int length) noexcept {
+            const std::shared_ptr<Multiplexer> multiplexer = multiplexer_;
+            if (disposed_ || !multiplexer) {
+                return true;
+            }
+
+            /* Credit goes back a quarter window at a time rather than once per segment. */
+            consumed_ += length;
+            if (consumed_ < (multiplexer->window_size_ >> 2)) {
+                return true;
+            }
+
+            int increment = consumed_;
+            consumed_ = 0;
+            window_ += increment;
+            return multiplexer->SendControl(Multiplexer::FrameType_Window, Id, increment);
+        }
+
+        bool MultiplexStream::OnData(const std::shared_ptr<Byte>& buffer, int length) noexcept {
+            /* A peer that overruns the window it was given breaks the protocol for the whole leg pair. */
+            if (length > window_) {
+                return false;
+            }
+
+            window_ -= length;
+            if (disposed_ || remote_closed_) {
+                return true;
+            }
+
+            ReadAsyncCallback reading = std::move(reading_);
+            if (!reading) {
+                /* The window counts payload bytes while a queued payload pins the whole leg buffer, small ones move to a buffer of their own size. */
+                static const int MAX_SHARED_SEGMENT = uds::threading::Hosting::BufferSize >> 2;
+
+                std::shared_ptr<Byte> segment = buffer;
+                if (length < MAX_SHARED_SEGMENT) {
+                    segment = make_shared_alloc<Byte>(length);
+                    if (!segment) {
+                        Close();
+                        return true;
+                    }
+                    memcpy(segment.get(), buffer.get(), length);
+                }
+
+                read_segments_.push_back(ReadSegment(segment, length));
+                return true;
+            }
+
+            reading_ = NULL;
+            if (!Acknowledge(length)) {
+                Close();
+            }
+            reading(buffer, length);
+            return true;
+        }
+
+        bool MultiplexStream::OnWindow(UInt32 credit) noexcept {
+            if (!credit || credit > (UInt32)(INT32_MAX - credit_)) {
+                return false;
+            }
+
+            credit_ += (int)credit;
+            if (!Flush()) {
+                Close();
+            }
+            return true;
+        }
+
+        void MultiplexStream::OnClose() noexcept {
+            /* What already arrived is still read, the end of the stream follows it. */
+            remote_closed_ = true;
+            write_segments_.clear();
+
+            ReadAsyncCallback reading = std::move(reading_);
+            reading_ = NULL;
+            if (reading) {
+                reading(NULL, -1);
+            }
+            elif(read_segments_.empty()) {
+                Close();
+            }
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <uds/tunnel/Multiplexer.h>
+
+namespace uds {
+    namespace tunnel {
+        /* One logical stream of a multiplexer, the connection reads and writes it like the two legs of its own. */
+        class MultiplexStream : public uds::transmission::ITransmission {
+            friend class Multiplexer;
+
+        public:
+            const int                                               Id;
+
+        public:
+            MultiplexStream(const std::shared_ptr<Multiplexer>& multiplexer, int id) noexcept;
+
+        public:
+            virtual int                                             GetMaxSegmentSize() noexcept override;
+            virtual std::shared_ptr<boost::asio::io_context>        GetContext() noexcept override;
+            virtual bool                                            HandshakeAsync(HandshakeType type, const BOOST_ASIO_MOVE_ARG(HandshakeAsyncCallback) callback) noexcept override;
+            virtual bool                                            ReadAsync(const BOOST_ASIO_MOVE_ARG(ReadAsyncCallback) callback) noexcept override;
+            virtual bool                                            WriteAsync(const std::shared_ptr<Byte>& buffer, int offset, int length, const BOOST_ASIO_MOVE_ARG(WriteAsyncCallback) callback) noexcept override;
+            virtual bool                                            Relocate(const std::shared_ptr<boost::asio::io_context>& context) noexcept override;
+            virtual void                                            Dispose() noexcept override;
+            virtual uds::net::IPEndPoint                            GetLocalEndPoint() noexcept override;
+            virtual uds::net::IPEndPoint                            GetRemoteEndPoint() noexcept override;
+
+        private:
+            bool                                                    Listen() noexcept;
+            bool                                                    Flush() noexcept;
+            bool                                                    Acknowledge(int length) noexcept;
+            bool                                                    OnData(const std::shared_ptr<Byte>& buffer, int length) noexcept;
+            bool                                                    OnWindow(UInt32 credit) noexcept;
+            void                                                    OnClose() noexcept;
+
+        private:
+            struct WriteSegment {
+                std::shared_ptr<Byte>                               buffer;
+                int                                                 offset = 0;
+                int                                                 length = 0;
+                WriteAsyncCallback                                  callback;
+            };
+            using ReadSegment                                       = std::pair<std::shared_ptr<Byte>, int>;
+
+        private:
+            std::atomic<bool>                                       disposed_;
+            bool                                                    remote_closed_;
+            std::shared_ptr<Multiplexer>                            multiplexer_;
+            std::shared_ptr<boost::asio::io_context>                context_;
+            int                                                     window_;        /* Bytes the peer may still send before the next credit. */
+            int                                                     consumed_;      /* Bytes handed to the reader and not yet credited back. */
+            int                                                     credit_;        /* Bytes this side may still send. */
+            ReadAsyncCallback                                       reading_;
+            std::deque<ReadSegment>                                 read_segments_;
+            std::deque<WriteSegment>                                write_segments_;
+            uds::net::IPEndPoint                                    localEP_;
+            uds::net::IPEndPoint                                    remoteEP_;
+        };
+    }
+}
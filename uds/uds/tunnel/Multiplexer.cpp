@@ -0,0 +1,372 @@
+#include <uds/threading/Timer.h>
+#include <uds/tunnel/Multiplexer.h>
+#include <uds/tunnel/MultiplexStream.h>
+
+namespace uds {
+    namespace tunnel {
+        Multiplexer::Multiplexer(const AppConfigurationPtr& configuration, int id, const ITransmissionPtr& inbound, const ITransmissionPtr& outbound) noexcept
+            : Id(id)
+            , disposed_(false)
+            , available_(false)
+            , payload_size_(uds::threading::Hosting::BufferSize - MULTIPLEX_HEADER)
+            , window_size_(MULTIPLEX_WINDOW)
+            , configuration_(configuration)
+            , inbound_(inbound)
+            , outbound_(outbound) {
+            if (inbound) {
+                context_ = inbound->GetContext();
+            }
+
+            /* A frame must leave either leg as one message, so it is bounded by what the legs send unsplit after their own overhead. */
+            if (inbound && outbound) {
+                int segment_size = std::min<int>(inbound->GetMaxSegmentSize(), outbound->GetMaxSegmentSize());
+                if (segment_size > MULTIPLEX_HEADER) {
+                    payload_size_ = std::min<int>(payload_size_, segment_size - MULTIPLEX_HEADER);
+                }
+            }
+
+            if (configuration) {
+                window_size_ = std::max<int>(MULTIPLEX_WINDOW, configuration->Multiplex.Window);
+            }
+        }
+
+        bool Multiplexer::Listen() noexcept {
+            if (disposed_ || available_ || !inbound_ || !outbound_ || !context_ || !configuration_) {
+                return false;
+            }
+
+            available_ = ReadInboundCycle() && ReadOutboundCycle();
+            if (available_) {
+                if (configuration_->KeepAlived) {
+                    available_ = KeepAlivedSendCycle();
+                }
+            }
+            return available_;
+        }
+
+        bool Multiplexer::Available() noexcept {
+            return available_ && !disposed_;
+        }
+
+        Multiplexer::AsyncContextPtr Multiplexer::GetContext() noexcept {
+            return context_;
+        }
+
+        void Multiplexer::Close() noexcept {
+            const AsyncContextPtr context = GetContext();
+            if (!context) {
+                Dispose();
+                return;
+            }
+
+            /* The multiplexer and all of its streams are owned by the worker context of its inbound leg. */
+            const std::shared_ptr<Reference> references = GetReference();
+            boost::asio::dispatch(*context,
+                [references, this]() noexcept {
+                    Dispose();
+                });
+        }
+
+        void Multiplexer::Dispose() noexcept {
+            if (!disposed_.exchange(true)) {
+                const ITransmissionPtr inbound = std::move(inbound_);
+                if (inbound) {
+                    inbound->Close();
+                }
+
+                const ITransmissionPtr outbound = std::move(outbound_);
+                if (outbound) {
+                    const AsyncContextPtr context = outbound->GetContext();
+                    if (context) {
+                        boost::asio::dispatch(*context,
+                            [outbound]() noexcept {
+                                outbound->Close();
+                            });
+                    }
+                    else {
+                        outbound->Close();
+                    }
+                }
+
+                /* Every stream ends with its leg pair, they find the table empty and send nothing. */
+                MultiplexStreamTable streams = std::move(streams_);
+                streams_.clear();
+                for (MultiplexStreamTable::iterator tail = streams.begin(), endl = streams.end(); tail != endl; tail++) {
+                    tail->second->Close();
+                }
+
+                inbound_.reset();
+                outbound_.reset();
+                uds::threading::ClearTimeout(timeout_);
+
+                DisposedEventHandler disposedEvent = std::move(DisposedEvent);
+                if (disposedEvent) {
+                    DisposedEvent = NULL;
+                    disposedEvent(this);
+                }
+                OpenEvent = NULL;
+            }
+        }
+
+        Multiplexer::ITransmissionPtr Multiplexer::Open(int streamId) noexcept {
+            if (disposed_ || !available_ || !streamId) {
+                return NULL;
+            }
+
+            if (streams_.find(streamId) != streams_.end()) {
+                return NULL;
+            }
+
+            /* The open frame goes first, the credit of the new stream follows it. */
+            if (!SendControl(FrameType_Open, streamId, 0)) {
+                return NULL;
+            }
+            return NewStream(streamId);
+        }
+
+        Multiplexer::MultiplexStreamPtr Multiplexer::NewStream(int streamId) noexcept {
+            const std::shared_ptr<Multiplexer> multiplexer = CastReference<Multiplexer>(GetReference());
+            if (!multiplexer) {
+                return NULL;
+            }
+
+            const MultiplexStreamPtr stream = make_shared_object<MultiplexStream>(multiplexer, streamId);
+            if (!stream) {
+                return NULL;
+            }
+
+            stream->Constructor(stream);
+            streams_[streamId] = stream;
+            if (stream->Listen()) {
+                return stream;
+            }
+
+            stream->Close();
+            return NULL;
+        }
+
+        void Multiplexer::CloseStream(int streamId, bool notify) noexcept {
+            MultiplexStreamTable::iterator tail = streams_.find(streamId);
+            if (tail == streams_.end()) {
+                return;
+            }
+
+            streams_.erase(tail);
+            if (notify && !SendControl(FrameType_Close, streamId, 0)) {
+                Close();
+            }
+        }
+
+        bool Multiplexer::ReadInboundCycle() noexcept {
+            const ITransmissionPtr transmission = inbound_;
+            if (disposed_ || !transmission) {
+                return false;
+            }
+
+            const std::shared_ptr<Reference> references = GetReference();
+            return transmission->ReadAsync(
+                [references, this](const std::shared_ptr<Byte>& buffer, int length) noexcept {
+                    if (length < 1 || !OnFrame(buffer, length) || !ReadInboundCycle()) {
+                        Close();
+                    }
+                });
+        }
+
+        bool Multiplexer::ReadOutboundCycle() noexcept {
+            const ITransmissionPtr transmission = outbound_;
+            if (disposed_ || !transmission) {
+                return false;
+            }
+
+            const AsyncContextPtr context = transmission->GetContext();
+            if (!context) {
+                return false;
+            }
+
+            /* The peer sends nothing on the leg this side writes, a read there notices the leg going down between two writes. */
+            const std::shared_ptr<Reference> references = GetReference();
+            boost::asio::dispatch(*context,
+                [references, this, transmission]() noexcept {
+                    bool success = transmission->ReadAsync(
+                        [references, this](const std::shared_ptr<Byte>&, int length) noexcept {
+                            if (length < 1 || !ReadOutboundCycle()) {
+                                Close();
+                            }
+                        });
+                    if (!success) {
+                        Close();
+                    }
+                });
+            return true;
+        }
+
+        bool Multiplexer::KeepAlivedSendCycle() noexcept {
+            if (disposed_) {
+                return false;
+            }
+
+            if (timeout_) {
+                uds::threading::ClearTimeout(timeout_);
+            }
+
+            const std::shared_ptr<Reference> references = GetReference();
+            timeout_ = uds::threading::SetTimeout(context_,
+                [references, this](void*) noexcept {
+                    if (timeout_) {
+                        uds::threading::ClearTimeout(timeout_);
+                    }
+
+                    std::shared_ptr<Byte> packet = make_shared_alloc<Byte>(MULTIPLEX_HEADER + 64);
+                    if (!packet) {
+                        Close();
+                        return;
+                    }
+
+                    int padding_size = RandomNext(8, 64);
+                    RandomAscii((Char*)packet.get() + MULTIPLEX_HEADER, padding_size);
+                    if (!SendFrame(FrameType_Ping, 0, packet, padding_size,
+                        [references, this](bool success) noexcept {
+                            if (!success || !KeepAlivedSendCycle()) {
+                                Close();
+                            }
+                        })) {
+                        Close();
+                    }
+                }, RandomNext(100, 500));
+            return NULL != timeout_;
+        }
+
+        bool Multiplexer::OnFrame(const std::shared_ptr<Byte>& buffer, int length) noexcept {
+            if (!buffer || length < MULTIPLEX_HEADER) {
+                return false;
+            }
+
+            Byte* p = buffer.get();
+            int type = p[0];
+            int streamId = p[1] << 24 | p[2] << 16 | p[3] << 8 | p[4];
+            int payload_size = length - MULTIPLEX_HEADER;
+            if (type == FrameType_Ping) {
+                return true;
+            }
+            elif(!streamId) {
+                return false;
+            }
+
+            MultiplexStreamPtr stream;
+            MultiplexStreamTable::iterator tail = streams_.find(streamId);
+            if (tail != streams_.end()) {
+                stream = tail->second;
+            }
+
+            /* Only the client opens streams, the server answers an open it refuses with a close. */
+            if (type == FrameType_Open) {
+                if (stream || !OpenEvent) {
+                    return false;
+                }
+
+                stream = NewStream(streamId);
+                if (!stream) {
+                    return SendControl(FrameType_Close, streamId, 0);
+                }
+                elif(!OpenEvent(this, stream)) {
+                    stream->Close();
+                }
+                return true;
+            }
+            elif(type == FrameType_Data) {
+                if (payload_size < 1) {
+                    return false;
+                }
+                elif(!stream) {
+                    return true; /* Still in flight when this side closed the stream. */
+                }
+
+                /* The stream keeps the leg's receive buffer and reads the payload in place. */
+                return stream->OnData(std::shared_ptr<Byte>(buffer, p + MULTIPLEX_HEADER), payload_size);
+            }
+            elif(type == FrameType_Window) {
+                if (payload_size != 4) {
+                    return false;
+                }
+                elif(!stream) {
+                    return true;
+                }
+
+                Byte* credit = p + MULTIPLEX_HEADER;
+                return stream->OnWindow((UInt32)credit[0] << 24 | (UInt32)credit[1] << 16 | (UInt32)credit[2] << 8 | (UInt32)credit[3]);
+            }
+            elif(type == FrameType_Close) {
+                if (stream) {
+                    stream->OnClose();
+                }
+                return true;
+            }
+            return false;
+        }
+
+        bool Multiplexer::SendControl(FrameType type, int streamId, int value) noexcept {
+            int length = type == FrameType_Window ? 4 : 0;
+            std::shared_ptr<Byte> packet = make_shared_alloc<Byte>(MULTIPLEX_HEADER + 4);
+            if (!packet) {
+                return false;
+            }
+
+            Byte* p = packet.get() + MULTIPLEX_HEADER;
+            p[0] = (Byte)(value >> 24);
+            p[1] = (Byte)(value >> 16);
+            p[2] = (Byte)(value >> 8);
+            p[3] = (Byte)(value);
+            return SendFrame(type, streamId, packet, length, NULL);
+        }
+
+        bool Multiplexer::SendFrame(FrameType type, int streamId, const std::shared_ptr<Byte>& packet, int length, WriteAsyncCallback&& callback) noexcept {
+            const ITransmissionPtr transmission = outbound_;
+            if (disposed_ || !transmission || !packet || length < 0) {
+                return false;
+            }
+
+            const AsyncContextPtr context = transmission->GetContext();
+            if (!context) {
+                return false;
+            }
+
+            /* A split frame would be parsed as two on the other side, one that does not fit is a bug of the sender. */
+            if (MULTIPLEX_HEADER + length > transmission->GetMaxSegmentSize()) {
+                return false;
+            }
+
+            Byte* p = packet.get();
+            p[0] = (Byte)type;
+            p[1] = (Byte)(streamId >> 24);
+            p[2] = (Byte)(streamId >> 16);
+            p[3] = (Byte)(streamId >> 8);
+            p[4] = (Byte)(streamId);
+
+            /* The outbound leg may live on another worker context, completions come back to the one of the streams. */
+            const std::shared_ptr<Reference> references = GetReference();
+            const std::shared_ptr<Byte> buffers = packet;
+            const WriteAsyncCallback callback_ = std::move(callback);
+            const int packet_size = MULTIPLEX_HEADER + length;
+            boost::asio::dispatch(*context,
+                [references, this, transmission, buffers, packet_size, callback_]() noexcept {
+                    bool success = transmission->WriteAsync(buffers, 0, packet_size,
+                        [references, this, callback_](bool success) noexcept {
+                            if (!success) {
+                                Close();
+                            }
+
+                            if (callback_) {
+                                boost::asio::dispatch(*context_,
+                                    [callback_, success]() noexcept {
+                                        callback_(success);
+                                    });
+                            }
+                        });
+                    if (!success) {
+                        Close();
+                    }
+                });
+            return true;
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <uds/IDisposable.h>
+#include <uds/threading/Hosting.h>
+#include <uds/transmission/ITransmission.h>
+#include <uds/configuration/AppConfiguration.h>
+
+namespace uds {
+    namespace tunnel {
+        class MultiplexStream;
+
+        /* Carries many streams over one long-lived leg pair, each leg message is one frame tagged with the stream it belongs to. */
+        class Multiplexer : public IDisposable {
+            friend class MultiplexStream;
+
+        public:
+            using ITransmission                 = uds::transmission::ITransmission;
+            using ITransmissionPtr              = std::shared_ptr<ITransmission>;
+            using WriteAsyncCallback            = ITransmission::WriteAsyncCallback;
+            using AppConfiguration              = uds::configuration::AppConfiguration;
+            using AppConfigurationPtr           = std::shared_ptr<AppConfiguration>;
+            using AsyncContextPtr               = std::shared_ptr<boost::asio::io_context>;
+            using AsyncDeadlineTimerPtr         = std::shared_ptr<boost::asio::deadline_timer>;
+            using MultiplexStreamPtr            = std::shared_ptr<MultiplexStream>;
+            using MultiplexStreamTable          = std::unordered_map<int, MultiplexStreamPtr>;
+
+        public:
+            using OpenEventHandler              = std::function<bool(Multiplexer*, const ITransmissionPtr&)>;
+            using DisposedEventHandler          = std::function<void(Multiplexer*)>;
+
+        public:
+            enum FrameType {
+                FrameType_Open = 1,             /* The client opens a stream, no payload. */
+                FrameType_Data,                 /* Stream payload, counted against the window of the receiver. */
+                FrameType_Window,               /* 4-byte credit the receiver hands back once it consumed that much. */
+                FrameType_Close,                /* Either side tears the stream down, no payload. */
+                FrameType_Ping,                 /* Random padding on stream 0 that keeps an idle leg pair busy. */
+            };
+            static const int                    MULTIPLEX_HEADER = 5;
+            static const int                    MULTIPLEX_WINDOW = 65536;
+            const int                           Id;
+            OpenEventHandler                    OpenEvent;
+            DisposedEventHandler                DisposedEvent;
+
+        public:
+            Multiplexer(const AppConfigurationPtr& configuration, int id, const ITransmissionPtr& inbound, const ITransmissionPtr& outbound) noexcept;
+
+        public:
+            virtual bool                        Listen() noexcept;
+            virtual void                        Dispose() noexcept override;
+            void                                Close() noexcept;
+            bool                                Available() noexcept;
+            ITransmissionPtr                    Open(int streamId) noexcept;
+            AsyncContextPtr                     GetContext() noexcept;
+
+        private:
+            MultiplexStreamPtr                  NewStream(int streamId) noexcept;
+            void                                CloseStream(int streamId, bool notify) noexcept;
+            bool                                OnFrame(const std::shared_ptr<Byte>& buffer, int length) noexcept;
+            bool                                ReadInboundCycle() noexcept;
+            bool                                ReadOutboundCycle() noexcept;
+            bool                                KeepAlivedSendCycle() noexcept;
+
+        private:
+            bool                                SendFrame(FrameType type, int streamId, const std::shared_ptr<Byte>& packet, int length, WriteAsyncCallback&& callback) noexcept;
+            bool                                SendControl(FrameType type, int streamId, int value) noexcept;
+
+        private:
+            std::atomic<bool>                   disposed_;
+            bool                                available_;
+            int                                 payload_size_;
+            int                                 window_size_;
+            AppConfigurationPtr                 configuration_;
+            AsyncContextPtr                     context_;
+            ITransmissionPtr                    inbound_;
+            ITransmissionPtr                    outbound_;
+            AsyncDeadlineTimerPtr               timeout_;
+            MultiplexStreamTable                streams_;
+        };
+    }
+}
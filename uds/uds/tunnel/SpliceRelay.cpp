@@ -0,0 +1,267 @@
+#include <uds/tunnel/SpliceRelay.h>
+
+#ifdef LINUX
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/socket.h>
+#endif
+
+namespace uds {
+    namespace tunnel {
+        SpliceRelay::SpliceRelay(const AsyncTcpSocketPtr& source, const AsyncTcpSocketPtr& destination, FramingMode mode, int mss) noexcept
+            : disposed_(false)
+            , mode_(mode)
+            , mss_(mss)
+            , pipe_size_(0)
+            , header_size_(0)
+            , packet_size_(0)
+            , source_(source)
+            , destination_(destination) {
+            pipe_[0] = -1;
+            pipe_[1] = -1;
+        }
+
+        SpliceRelay::~SpliceRelay() noexcept {
+            Close();
+        }
+
+        bool SpliceRelay::IsSupported() noexcept {
+#ifdef LINUX
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        void SpliceRelay::Close() noexcept {
+            if (!disposed_) {
+                disposed_ = true;
+                for (int i = 0; i < (int)arraysizeof(pipe_); i++) {
+                    int fd = pipe_[i];
+                    if (fd != -1) {
+                        pipe_[i] = -1;
+                        ::close(fd);
+                    }
+                }
+
+                ClosedEventHandler closedEvent = std::move(ClosedEvent);
+                if (closedEvent) {
+                    ClosedEvent = NULL;
+                    closedEvent(this);
+                }
+            }
+        }
+
+        bool SpliceRelay::Run() noexcept {
+#ifdef LINUX
+            if (disposed_ || !source_ || !destination_ || mss_ < 1 || mss_ > UINT16_MAX) {
+                return false;
+            }
+
+            if (pipe2(pipe_, O_NONBLOCK | O_CLOEXEC) < 0) {
+                return false;
+            }
+
+            /* A single packet must fit into the pipe. */
+            if (fcntl(pipe_[0], F_GETPIPE_SZ) < mss_ && fcntl(pipe_[0], F_SETPIPE_SZ, mss_) < mss_) {
+                return false;
+            }
+
+            boost::system::error_code ec;
+            source_->non_blocking(true, ec);
+            if (ec) {
+                return false;
+            }
+
+            destination_->non_blocking(true, ec);
+            if (ec) {
+                return false;
+            }
+            return Next();
+#else
+            return false;
+#endif
+        }
+
+        bool SpliceRelay::OnReadAsync() noexcept {
+            const std::shared_ptr<Reference> references = GetReference();
+            source_->async_wait(boost::asio::ip::tcp::socket::wait_read,
+                [references, this](const boost::system::error_code& ec) noexcept {
+                    if (ec || !Next()) {
+                        Close();
+                    }
+                });
+            return true;
+        }
+
+        bool SpliceRelay::OnWriteAsync() noexcept {
+            const std::shared_ptr<Reference> references = GetReference();
+            destination_->async_wait(boost::asio::ip::tcp::socket::wait_write,
+                [references, this](const boost::system::error_code& ec) noexcept {
+                    if (ec || !Next()) {
+                        Close();
+                    }
+                });
+            return true;
+        }
+
+        bool SpliceRelay::Next() noexcept {
+            if (disposed_) {
+                return false;
+            }
+
+            /* Yield to the other connections of this context after a burst of progress. */
+            const int MAX_STEPS = 64;
+            for (int steps = 0; steps < MAX_STEPS; steps++) {
+                bool wait_write = false;
+                int status = mode_ == FramingMode_Pack ? Pack(wait_write) : Unpack(wait_write);
+                if (status < 0) {
+                    return false;
+                }
+                elif(status == 0) {
+                    return wait_write ? OnWriteAsync() : OnReadAsync();
+                }
+            }
+
+            const std::shared_ptr<Reference> references = GetReference();
+            boost::asio::post(source_->get_executor(),
+                [references, this]() noexcept {
+                    if (!Next()) {
+                        Close();
+                    }
+                });
+            return true;
+        }
+
+        int SpliceRelay::Drain() noexcept {
+#ifdef LINUX
+            ssize_t n = splice(pipe_[0], NULL, destination_->native_handle(), NULL, pipe_size_, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            if (n > 0) {
+                pipe_size_ -= (int)n;
+            }
+            return (int)n;
+#else
+            return -1;
+#endif
+        }
+
+        int SpliceRelay::Pack(bool& wait_write) noexcept {
+#ifdef LINUX
+            /* Pull whatever the raw stream has into the pipe, the amount becomes the length prefix. */
+            if (!pipe_size_) {
+                ssize_t n = splice(source_->native_handle(), NULL, pipe_[1], NULL, mss_, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+                if (n > 0) {
+                    pipe_size_ = (int)n;
+                    packet_size_ = (int)n;
+                    header_size_ = 0;
+                    header_[0] = (Byte)(n >> 8);
+                    header_[1] = (Byte)(n);
+                    return 1;
+                }
+                elif(n == 0) {
+                    return -1;
+                }
+                elif(errno == EINTR) {
+                    return 1;
+                }
+                elif(errno == EAGAIN || errno == EWOULDBLOCK) {
+                    wait_write = false;
+                    return 0;
+                }
+                return -1;
+            }
+
+            /* The prefix is corked onto the spliced payload that follows it. */
+            if (header_size_ < (int)arraysizeof(header_)) {
+                ssize_t n = send(destination_->native_handle(), header_ + header_size_, arraysizeof(header_) - header_size_, MSG_MORE | MSG_NOSIGNAL | MSG_DONTWAIT);
+                if (n > 0) {
+                    header_size_ += (int)n;
+                    return 1;
+                }
+                elif(n < 0 && errno == EINTR) {
+                    return 1;
+                }
+                elif(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    wait_write = true;
+                    return 0;
+                }
+                return -1;
+            }
+
+            int n = Drain();
+            if (n > 0) {
+                if (!pipe_size_) {
+                    packet_size_ = 0;
+                }
+                return 1;
+            }
+            elif(n < 0 && errno == EINTR) {
+                return 1;
+            }
+            elif(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                wait_write = true;
+                return 0;
+            }
+#endif
+            return -1;
+        }
+
+        int SpliceRelay::Unpack(bool& wait_write) noexcept {
+#ifdef LINUX
+            /* Empty the pipe first, an EAGAIN on the fill below then always means the source is dry. */
+            if (pipe_size_) {
+                int n = Drain();
+                if (n > 0) {
+                    return 1;
+                }
+                elif(n < 0 && errno == EINTR) {
+                    return 1;
+                }
+                elif(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    wait_write = true;
+                    return 0;
+                }
+                return -1;
+            }
+
+            ssize_t n;
+            if (!packet_size_) {
+                n = recv(source_->native_handle(), header_ + header_size_, arraysizeof(header_) - header_size_, MSG_DONTWAIT);
+                if (n > 0) {
+                    header_size_ += (int)n;
+                    if (header_size_ < (int)arraysizeof(header_)) {
+                        return 1;
+                    }
+
+                    header_size_ = 0;
+                    packet_size_ = header_[0] << 8 | header_[1];
+                    if (packet_size_ < 1 || packet_size_ > mss_) {
+                        return -1;
+                    }
+                    return 1;
+                }
+            }
+            else {
+                n = splice(source_->native_handle(), NULL, pipe_[1], NULL, packet_size_, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+                if (n > 0) {
+                    packet_size_ -= (int)n;
+                    pipe_size_ += (int)n;
+                    return 1;
+                }
+            }
+
+            if (n == 0) {
+                return -1;
+            }
+            elif(errno == EINTR) {
+                return 1;
+            }
+            elif(errno == EAGAIN || errno == EWOULDBLOCK) {
+                wait_write = false;
+                return 0;
+            }
+#endif
+            return -1;
+        }
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <uds/Reference.h>
+
+namespace uds {
+    namespace tunnel {
+        /* Moves one direction of a plain TCP tunnel through a kernel pipe with splice(2), the payload never enters user space. */
+        class SpliceRelay : public Reference {
+        public:
+            using AsyncTcpSocketPtr             = std::shared_ptr<boost::asio::ip::tcp::socket>;
+            using ClosedEventHandler            = std::function<void(SpliceRelay*)>;
+
+        public:
+            enum FramingMode {
+                FramingMode_Pack,               /* Raw stream in, 2-byte length framed stream out. */
+                FramingMode_Unpack,             /* 2-byte length framed stream in, raw stream out. */
+            };
+            ClosedEventHandler                  ClosedEvent;
+
+        public:
+            SpliceRelay(const AsyncTcpSocketPtr& source, const AsyncTcpSocketPtr& destination, FramingMode mode, int mss) noexcept;
+            ~SpliceRelay() noexcept;
+
+        public:
+            static bool                         IsSupported() noexcept;
+            bool                                Run() noexcept;
+            void                                Close() noexcept;
+
+        private:
+            bool                                OnReadAsync() noexcept;
+            bool                                OnWriteAsync() noexcept;
+            bool                                Next() noexcept;
+            int                                 Pack(bool& wait_write) noexcept;
+            int                                 Unpack(bool& wait_write) noexcept;
+            int                                 Drain() noexcept;
+
+        private:
+            bool                                disposed_;
+            FramingMode                         mode_;
+            int                                 mss_;
+            int                                 pipe_[2];
+            int                                 pipe_size_;
+            Byte                                header_[2];
+            int                                 header_size_;
+            int                                 packet_size_;
+            AsyncTcpSocketPtr                   source_;
+            AsyncTcpSocketPtr                   destination_;
+        };
+    }
+}